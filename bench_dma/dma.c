@@ -0,0 +1,172 @@
+/**
+ * @file
+ * @brief Measuring the latency and throughput of DMAs between MRAM and WRAM,
+ * as well as the overhead of calling a function through the `algos` table.
+ *
+ * Each tasklet moves its part of the input in blocks of a fixed size.
+ * The blocks either start at addresses aligned to their size or are shifted by `DMA_ALIGNMENT`.
+ * The test named `Call` does nothing, so its time is the residual call overhead;
+ * compile with `CALL_OVERHEAD=0` to measure the call overhead itself.
+ * No data are sorted and the writes overwrite the input, so nothing is reported as sorted.
+**/
+
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <barrier.h>
+#include <defs.h>
+#include <memmram_utils.h>
+#include <perfcounter.h>
+
+#include "buffers.h"
+#include "communication.h"
+#include "mram_loop.h"
+
+#if (TRIPLE_BUFFER_SIZE < 2048)
+#error The DMA benchmark needs at least 2048 bytes of triple buffer to transfer the biggest blocks.
+#endif
+
+struct dpu_arguments __host host_to_dpu;
+struct dpu_results __host dpu_to_host;
+T __mram_noinit_keep input[LOAD_INTO_MRAM];  // set by the host
+
+triple_buffers buffers[NR_TASKLETS];
+dpu_time times[NR_TASKLETS];
+
+BARRIER_INIT(omni_barrier, NR_TASKLETS);
+
+/**
+ * @brief Moves blocks of a fixed size between some MRAM range and the cache.
+ * The first block starts at the first address within the range which is aligned to the block size,
+ * plus the given shift. Incomplete blocks at the end are not moved.
+ *
+ * @param start The first item of the MRAM range.
+ * @param end The last item of the MRAM range.
+ * @param block_size The number of bytes moved by each DMA.
+ * @param shift The number of bytes by which the blocks are shifted.
+ * @param write Whether to write from WRAM to MRAM instead of reading from MRAM to WRAM.
+**/
+static __attribute__((always_inline)) inline void transfer_blocks(T __mram_ptr * const start,
+        T __mram_ptr * const end, size_t const block_size, size_t const shift, bool const write) {
+    T * const cache = buffers[me()].cache;
+    uint8_t __mram_ptr * const base = (uint8_t __mram_ptr *)input;
+    size_t const last = (size_t)(end - input + 1) << DIV;
+    for (size_t at = ALIGN((size_t)(start - input) << DIV, block_size) + shift;
+            at + block_size <= last; at += block_size) {
+        if (write)
+            mram_write(cache, &base[at], block_size);
+        else
+            mram_read(&base[at], cache, block_size);
+    }
+}
+
+/**
+ * @brief Creates four tests moving blocks of the given size,
+ * named `read_<size>`, `read_<size>_shifted`, `write_<size>`, and `write_<size>_shifted`.
+ *
+ * @param size The number of bytes moved by each DMA.
+**/
+#define DMA_TESTS(size)                                                                     \
+static void read_##size(T __mram_ptr * const start, T __mram_ptr * const end) {             \
+    transfer_blocks(start, end, size, 0, false);                                            \
+}                                                                                           \
+static void read_##size##_shifted(T __mram_ptr * const start, T __mram_ptr * const end) {   \
+    transfer_blocks(start, end, size, DMA_ALIGNMENT, false);                                \
+}                                                                                           \
+static void write_##size(T __mram_ptr * const start, T __mram_ptr * const end) {            \
+    transfer_blocks(start, end, size, 0, true);                                             \
+}                                                                                           \
+static void write_##size##_shifted(T __mram_ptr * const start, T __mram_ptr * const end) {  \
+    transfer_blocks(start, end, size, DMA_ALIGNMENT, true);                                 \
+}
+
+DMA_TESTS(8)
+DMA_TESTS(16)
+DMA_TESTS(32)
+DMA_TESTS(64)
+DMA_TESTS(128)
+DMA_TESTS(256)
+DMA_TESTS(512)
+DMA_TESTS(1024)
+DMA_TESTS(2048)
+
+/**
+ * @brief Does nothing so that only the overhead of the call is measured.
+ *
+ * @param start Unused.
+ * @param end Unused.
+**/
+static __noinline void empty_call(T __mram_ptr * const start, T __mram_ptr * const end) {
+    (void)start;
+    (void)end;
+}
+
+/// @brief Adds the four tests of a block size to the list of algorithms.
+#define DMA_ALGOS(size)                                                 \
+    {{ "Read" #size, { .mram = read_##size } }},                        \
+    {{ "Read" #size "Shift", { .mram = read_##size##_shifted } }},      \
+    {{ "Write" #size, { .mram = write_##size } }},                      \
+    {{ "Write" #size "Shift", { .mram = write_##size##_shifted } }}
+
+union algo_to_test __host algos[] = {
+    {{ "Call", { .mram = empty_call } }},
+    DMA_ALGOS(8),
+    DMA_ALGOS(16),
+    DMA_ALGOS(32),
+    DMA_ALGOS(64),
+    DMA_ALGOS(128),
+    DMA_ALGOS(256),
+    DMA_ALGOS(512),
+    DMA_ALGOS(1024),
+    DMA_ALGOS(2048),
+};
+size_t __host num_of_algos = sizeof algos / sizeof algos[0];
+
+int main(void) {
+    /* Set up buffers. */
+    if (buffers[me()].cache == NULL) {  // Only allocate on the first launch.
+        allocate_triple_buffer(&buffers[me()]);
+    }
+
+    /* Set up dummy values if called via debugger. */
+    if (me() == 0 && host_to_dpu.length == 0) {
+        host_to_dpu.reps = 1;
+        host_to_dpu.length = 0x10000;
+        host_to_dpu.offset = DMA_ALIGNED(host_to_dpu.length * sizeof(T)) / sizeof(T);
+        host_to_dpu.part_length =
+                DMA_ALIGNED(DIV_CEIL(host_to_dpu.length, NR_TASKLETS) * sizeof(T)) / sizeof(T);
+        host_to_dpu.algo_index = 0;
+    }
+    barrier_wait(&omni_barrier);
+
+    /* Perform test. */
+    mram_range range = {
+        me() * host_to_dpu.part_length,
+        (me() == NR_TASKLETS - 1) ? host_to_dpu.offset : (me() + 1) * host_to_dpu.part_length,
+    };
+    sort_algo_mram * const algo = algos[host_to_dpu.algo_index].data.fct.mram;
+    memset(&dpu_to_host, 0, sizeof dpu_to_host);
+    dpu_to_host.sorted_parts = 0;  // Nothing is sorted, so nothing is to be verified.
+    dpu_to_host.sorted_length = host_to_dpu.offset;
+
+    for (uint32_t rep = 0; rep < host_to_dpu.reps; rep++) {
+        barrier_wait(&omni_barrier);
+        perfcounter_config(COUNT_CYCLES, true);
+        dpu_time new_time = perfcounter_get();
+        algo(&input[range.start], &input[range.end - 1]);
+        new_time = perfcounter_get() - new_time - CALL_OVERHEAD;
+        times[me()] = new_time;
+        barrier_wait(&omni_barrier);
+        if (me() == 0) {
+            for (size_t i = 1; i < NR_TASKLETS; i++)
+                times[0] = (times[i] > times[0]) ? times[i] : times[0];
+            dpu_to_host.times[rep] = times[0];
+        }
+
+        range.start += host_to_dpu.offset;
+        range.end += host_to_dpu.offset;
+    }
+
+    return EXIT_SUCCESS;
+}
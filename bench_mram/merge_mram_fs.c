@@ -14,8 +14,10 @@
 
 #include "checkers.h"
 #include "communication.h"
+#include "mram_pipeline.h"
 #include "mram_sorts.h"
 #include "random_distribution.h"
+#include "starting_runs.h"
 
 struct dpu_arguments __host host_to_dpu;
 struct dpu_results __host dpu_to_host;
@@ -37,8 +39,20 @@ static void merge_sort_full_space(T __mram_ptr * const start, T __mram_ptr * con
     merge_sort_mram(start, end);
 }
 
+/**
+ * @brief A full-space MergeSort where each pair of tasklets sorts both of their parts,
+ * with one tasklet merging in WRAM and the other one doing all DMAs.
+ *
+ * @param start The first item of the MRAM array to sort.
+ * @param end The last item of said array.
+**/
+static void merge_sort_pipelined(T __mram_ptr * const start, T __mram_ptr * const end) {
+    merge_sort_mram_pipelined(start, end);
+}
+
 union algo_to_test __host algos[] = {
     {{ "MergeFS", { .mram = merge_sort_full_space } }},
+    {{ "MergeFSPipe", { .mram = merge_sort_pipelined } }},
 };
 size_t __host num_of_algos = sizeof algos / sizeof algos[0];
 
@@ -58,6 +72,7 @@ int main(void) {
                 DMA_ALIGNED(DIV_CEIL(host_to_dpu.length, NR_TASKLETS) * sizeof(T)) / sizeof(T);
         host_to_dpu.basic_seed = 0b1011100111010;
         host_to_dpu.algo_index = 0;
+        host_to_dpu.active_tasklets = NR_TASKLETS;
         input_rngs[me()] = seed_xs(host_to_dpu.basic_seed + me());
         mram_range range = { 0, host_to_dpu.length * host_to_dpu.reps };
         generate_uniform_distribution_mram(input, cache, &range, 8);
@@ -65,12 +80,20 @@ int main(void) {
     barrier_wait(&omni_barrier);
 
     /* Perform test. */
-    mram_range range = {
-        me() * host_to_dpu.part_length,
-        (me() == NR_TASKLETS - 1) ? host_to_dpu.offset : (me() + 1) * host_to_dpu.part_length,
+    sysname_t const active = host_to_dpu.active_tasklets;
+    mram_range range = {  // Parked tasklets and those past the input get empty parts at the end.
+        (me() < active)
+                ? MIN(me() * host_to_dpu.part_length, host_to_dpu.offset)
+                : host_to_dpu.offset,
+        (me() + 1 < active)
+                ? MIN((me() + 1) * host_to_dpu.part_length, host_to_dpu.offset)
+                : host_to_dpu.offset,
     };
     sort_algo_mram * const algo = algos[host_to_dpu.algo_index].data.fct.mram;
     memset(&dpu_to_host, 0, sizeof dpu_to_host);
+    dpu_to_host.sorted_parts = active;
+    dpu_to_host.sorted_length = host_to_dpu.offset;
+    dpu_to_host.starting_run_length = shared_run_length(0);
 
     for (uint32_t rep = 0; rep < host_to_dpu.reps; rep++) {
         pivot_rngs[me()] = seed_xs_offset(host_to_dpu.basic_seed + me());
@@ -87,13 +110,15 @@ int main(void) {
         if (me() == 0) {
             for (size_t i = 1; i < NR_TASKLETS; i++)
                 times[0] = (times[i] > times[0]) ? times[i] : times[0];
-            dpu_to_host.firsts += times[0];
-            dpu_to_host.seconds += times[0] * times[0];
+            dpu_to_host.times[rep] = times[0];
+            // Each tasklet sets its entry of `flipped` anew before the next barrier.
+            for (size_t i = 0; i < active; i++)
+                dpu_to_host.parts_in_output |= (uint32_t)flipped[i] << i;
         }
 
         T __mram_ptr *sorted_array = (flipped[me()]) ? output : input;
-        flipped[me()] = false;  // Following sorting algorithms may not reset this value.
-        get_stats_sorted(sorted_array, cache, range, false, &stats_after);
+        get_stats_sorted(sorted_array, cache, range, false, dpu_to_host.sorted_parts == 1,
+                &stats_after);
         if (compare_stats(&stats_before, &stats_after, false) == EXIT_FAILURE) {
             abort();
         }
@@ -43,13 +43,13 @@ seqreader_t sr[NR_TASKLETS][2];  // sequential readers used to read runs
 **/
 static void merge_sort_half_space(T __mram_ptr * const start, T __mram_ptr * const end) {
     /* Starting runs. */
-    form_starting_runs(start, end);
+    size_t const starting_run_length = form_starting_runs(start, end);
 
     /* Merging. */
     seqreader_buffer_t wram[2] = { buffers[me()].seq_1, buffers[me()].seq_2 };
     size_t const n = end - start + 1;
-    T __mram_ptr * const out = (T __mram_ptr *)((uintptr_t)output + (uintptr_t)start);
-    for (size_t run_length = STARTING_RUN_LENGTH; run_length < n; run_length *= 2) {
+    T __mram_ptr * const out = &output[start - input];
+    for (size_t run_length = starting_run_length; run_length < n; run_length *= 2) {
         for (
             T __mram_ptr *run_1_end = end - run_length, *run_2_end = end;
             (intptr_t)run_1_end >= (intptr_t)start;
@@ -63,8 +63,8 @@ static void merge_sort_half_space(T __mram_ptr * const start, T __mram_ptr * con
             // … and merge the copy with the next run.
             T __mram_ptr * const ends[2] = { out + (run_1_end - run_1_start), run_2_end };
             T *ptr[2] = {
-                sr_init(buffers[me()].seq_1, out, &sr[me()][0]),
-                sr_init(buffers[me()].seq_2, run_1_end + 1, &sr[me()][1]),
+                sr_init(buffers[me()].seq_1, out, &sr[me()][0], ends[0]),
+                sr_init(buffers[me()].seq_2, run_1_end + 1, &sr[me()][1], ends[1]),
             };
             merge_mram_aligned(ptr, ends, run_1_start, wram);
         }
@@ -92,6 +92,7 @@ int main(void) {
                 DMA_ALIGNED(DIV_CEIL(host_to_dpu.length, NR_TASKLETS) * sizeof(T)) / sizeof(T);
         host_to_dpu.basic_seed = 0b1011100111010;
         host_to_dpu.algo_index = 0;
+        host_to_dpu.active_tasklets = NR_TASKLETS;
         input_rngs[me()] = seed_xs(host_to_dpu.basic_seed + me());
         mram_range range = { 0, host_to_dpu.length * host_to_dpu.reps };
         generate_uniform_distribution_mram(input, cache, &range, 8);
@@ -99,12 +100,20 @@ int main(void) {
     barrier_wait(&omni_barrier);
 
     /* Perform test. */
-    mram_range range = {
-        me() * host_to_dpu.part_length,
-        (me() == NR_TASKLETS - 1) ? host_to_dpu.offset : (me() + 1) * host_to_dpu.part_length,
+    sysname_t const active = host_to_dpu.active_tasklets;
+    mram_range range = {  // Parked tasklets and those past the input get empty parts at the end.
+        (me() < active)
+                ? MIN(me() * host_to_dpu.part_length, host_to_dpu.offset)
+                : host_to_dpu.offset,
+        (me() + 1 < active)
+                ? MIN((me() + 1) * host_to_dpu.part_length, host_to_dpu.offset)
+                : host_to_dpu.offset,
     };
     sort_algo_mram * const algo = algos[host_to_dpu.algo_index].data.fct.mram;
     memset(&dpu_to_host, 0, sizeof dpu_to_host);
+    dpu_to_host.sorted_parts = active;
+    dpu_to_host.sorted_length = host_to_dpu.offset;
+    dpu_to_host.starting_run_length = starting_run_length();
 
     for (uint32_t rep = 0; rep < host_to_dpu.reps; rep++) {
         pivot_rngs[me()] = seed_xs_offset(host_to_dpu.basic_seed + me());
@@ -121,11 +130,11 @@ int main(void) {
         if (me() == 0) {
             for (size_t i = 1; i < NR_TASKLETS; i++)
                 times[0] = (times[i] > times[0]) ? times[i] : times[0];
-            dpu_to_host.firsts += times[0];
-            dpu_to_host.seconds += times[0] * times[0];
+            dpu_to_host.times[rep] = times[0];
         }
 
-        get_stats_sorted(input, cache, range, false, &stats_after);
+        get_stats_sorted(input, cache, range, false, dpu_to_host.sorted_parts == 1,
+                &stats_after);
         if (compare_stats(&stats_before, &stats_after, false) == EXIT_FAILURE) {
             abort();
         }
@@ -14,9 +14,12 @@
 #include "checkers.h"
 #include "communication.h"
 #include "mram_merging.h"
+#define MRAM_MERGE UNALIGNED_FULL_SPACE
+#include "mram_merging_custom.h"
 #include "mram_sorts.h"
 #include "random_distribution.h"
 #include "reader.h"
+#include "starting_runs.h"
 
 struct dpu_arguments __host host_to_dpu;
 struct dpu_results __host dpu_to_host;
@@ -35,6 +38,7 @@ seqreader_t sr[NR_TASKLETS][2];  // sequential readers used to read runs
 bool flipped[NR_TASKLETS];  // Whether `output` contains the latest sorted runs.
 mram_range from[NR_TASKLETS][2];
 size_t borders[NR_TASKLETS];
+sysname_t share_ends[NR_TASKLETS];  // The tasklet after the last one with whom to share work.
 
 /**
  * @brief Finds the *greatest* index 𝘪 ∈ [`start`, `end`] such that `array[𝘪 – 1]` < `to_find`.
@@ -104,38 +108,120 @@ size_t binary_search(T const to_find, T __mram_ptr *array, size_t start, size_t
 #endif
 }
 
+/**
+ * @brief Calculates the index of the last element written by a tasklet during its last merge.
+ * Only valid once the tasklet is done with merging and before it is awoken anew.
+ * 
+ * @param leaf The Id of the tasklet.
+ * 
+ * @return The index of the last element written.
+**/
+static size_t get_tail(sysname_t const leaf) {
+    size_t const length = from[leaf][0].end - from[leaf][0].start + 1 +
+            from[leaf][1].end - from[leaf][1].start + 1;
+    return borders[leaf] + length - 1;
+}
+
+/**
+ * @brief Finds the node of the merge tree at a given depth which contains a tasklet.
+ * The tree splits the active tasklets of a node into two halves, the left one rounded up,
+ * until single tasklets remain, so leaves differ by at most one in depth.
+ * 
+ * @param tasklet The Id of the tasklet.
+ * @param depth The depth of the node, zero being the root.
+ * @param lo Whither to store the first tasklet of the node.
+ * @param hi Whither to store the tasklet after the last one of the node.
+ * 
+ * @return Whether the node merges, that is, whether it is no leaf.
+**/
+static bool find_node(sysname_t const tasklet, unsigned const depth, sysname_t *lo,
+        sysname_t *hi) {
+    *lo = 0;
+    *hi = host_to_dpu.active_tasklets;
+    for (unsigned d = 0; d < depth && *hi - *lo > 1; d++) {
+        sysname_t const mid = *lo + (*hi - *lo + 1) / 2;
+        if (tasklet < mid)
+            *hi = mid;
+        else
+            *lo = mid;
+    }
+    return *hi - *lo > 1;
+}
+
+/**
+ * @brief Calculates how often the run of a tasklet is merged, that is, the depth of its leaf.
+ * 
+ * @param tasklet The Id of the tasklet.
+ * 
+ * @return The depth of the leaf. That of the first tasklet is the height of the tree.
+**/
+static unsigned leaf_depth(sysname_t const tasklet) {
+    unsigned depth = 0;
+    sysname_t lo, hi;
+    while (find_node(tasklet, depth, &lo, &hi))
+        depth++;
+    return depth;
+}
+
+/**
+ * @brief Calculates the run merged by a node in the previous round.
+ * 
+ * @param lo The first tasklet of the node.
+ * @param hi The tasklet after the last one of the node.
+ * 
+ * @return The range of the run.
+**/
+static mram_range get_run(sysname_t const lo, sysname_t const hi) {
+    if (hi - lo == 1)  // Leaves hold their starting run.
+        return from[lo][0];
+    // The runs of the last round span from the head written by their roots
+    // to the tail written by their rightmost tasklets.
+    return (mram_range){ borders[lo], get_tail(hi - 1) };
+}
+
 /**
  * @brief Given `NR_TASKLETS` sorted MRAM runs, stored in from[…][0],
  * this function performs a parallel MergeSort based on a scheme by Cormen et al.
+ * Each node of the merge tree merges in the round given by its height,
+ * and all tasklets below it share the work.
+ * Tasklets whose leaves lie higher up idle in the first rounds.
 **/
 static __attribute__((unused)) void merge_par(void) {
+    if (me() >= host_to_dpu.active_tasklets) return;  // Parked tasklets have no run to merge.
+#if CUSTOM_READER
+    struct reader readers[2];
+    setup_reader(&readers[0], buffers[me()].seq_1, UNROLL_FACTOR);
+    setup_reader(&readers[1], buffers[me()].seq_2, UNROLL_FACTOR);
+#else
     seqreader_buffer_t const wram[2] = { buffers[me()].seq_1, buffers[me()].seq_2 };
-    unsigned char const trailing_zeros = (me() == 0) ? 32 : __builtin_ctz(me());
-    for (sysname_t round = 1; (1 << round) <= NR_TASKLETS; round++) {
+#endif
+    unsigned const height = leaf_depth(0);
+    for (unsigned round = 1; round <= height; round++) {
+        sysname_t lo, hi;
+        if (!find_node(me(), height - round, &lo, &hi))
+            continue;  // My run waits for its sibling to be merged.
         T __mram_ptr * const in = (flipped[me()]) ? output : input;
         T __mram_ptr * const out = (flipped[me()]) ? input : output;
-        sysname_t I = me();
-        // Are the `sub_round` LSB are all zero?
-        if (!(I & ((1 << round) - 1))) {
-            // If so, I am a root tasklet and have to wait for the tasklets within my tree.
-            for (sysname_t i = 1; i < (1 << round); i++) {
-                handshake_wait_for(I + i);  // “Successor, are you done with merging?”
+        sysname_t const I = me();
+        sysname_t end = hi;  // The tasklet after the last one whose work I still have to share.
+        if (I == lo) {
+            // I am the root and have to wait for the tasklets within my node.
+            for (sysname_t i = lo + 1; i < hi; i++) {
+                handshake_wait_for(i);  // “Successor, are you done with merging?”
             }
-            from[I][1] = from[I | (1 << (round - 1))][0];
+            sysname_t const mid = lo + (hi - lo + 1) / 2;
+            from[I][0] = get_run(lo, mid);
+            from[I][1] = get_run(mid, hi);
         } else {
             // If not, I am an inner tasklet and have to wait for my root to wake me up.
             handshake_notify();  // “Root, I am done with merging!”
             handshake_notify();  // “Root, wake me up when you are done with partitioning!”
+            end = share_ends[I];
         }
-        // I have been awoken and wake now sequentially the tasklets within my subtree,
-        // that is those with less zeroes in their LSB.
-        for (
-            sysname_t sub_round = (trailing_zeros > round) ? round : trailing_zeros;
-            sub_round >= 1;
-            sub_round--
-        ) {
-            sysname_t const thou = I ^ (1 << (sub_round - 1));
-            // Calculating the division points.
+        // I have been awoken and wake now the tasklets within my share, halving it each time.
+        while (end - I > 1) {
+            sysname_t const thou = I + (end - I + 1) / 2;
+            // Calculating the division points such that the shares match the numbers of tasklets.
             mram_range runs[2];  // 0: shorter; 1: longer
             if ((ptrdiff_t)(from[I][0].end - from[I][0].start) <=
                     (ptrdiff_t)(from[I][1].end - from[I][1].start)) {
@@ -145,10 +231,20 @@ static __attribute__((unused)) void merge_par(void) {
                 runs[0] = from[I][1];
                 runs[1] = from[I][0];
             }
-            size_t pivot = (runs[1].start + runs[1].end) / 2;
+            if ((intptr_t)runs[1].end < (intptr_t)runs[1].start) {
+                // Both runs are empty, so thou gettest nothing either and no pivot is written.
+                from[thou][0] = from[thou][1] = runs[1];
+                borders[thou] = borders[I];
+                share_ends[thou] = end;
+                handshake_wait_for(thou);
+                end = thou;
+                continue;
+            }
+            size_t pivot = runs[1].start + (runs[1].end - runs[1].start) * (thou - I) / (end - I);
             T const pivot_value = in[pivot];
 #if STABLE
-            if (in[pivot - 1] == pivot_value)  // Are there even duplicates to find?
+            // Are there even duplicates to find?
+            if (pivot > runs[1].start && in[pivot - 1] == pivot_value)
                 pivot = binary_search(pivot_value, in, runs[1].start, pivot - 1);
 #endif
             size_t const cut_at = binary_search(pivot_value, in, runs[0].start, runs[0].end);
@@ -160,25 +256,34 @@ static __attribute__((unused)) void merge_par(void) {
             from[thou][1].start = pivot + 1;
             from[thou][1].end = runs[1].end;
             borders[thou] = border + 1;
+            share_ends[thou] = end;
             handshake_wait_for(thou);
             // Saving mine own sections for either further division or for sorting, finally.
             from[I][0].start = runs[0].start;
             from[I][0].end = cut_at - 1;
             from[I][1].start = runs[1].start;
             from[I][1].end = pivot - 1;
+            end = thou;
         }
         // All tasklets within my subtree are awake, so I can process my two runs.
         T __mram_ptr *starts[2] = { &in[from[I][0].start], &in[from[I][1].start] };
         T __mram_ptr *ends[2] = { &in[from[I][0].end], &in[from[I][1].end] };
-        if ((intptr_t)starts[0] > (intptr_t)ends[0]) {  // The shorter run may be empty.
-            size_t offset = 0;
+        bool const empty[2] = {
+            (intptr_t)starts[0] > (intptr_t)ends[0],
+            (intptr_t)starts[1] > (intptr_t)ends[1],
+        };
+        if (empty[0] || empty[1]) {  // Either run may be empty if the pivot lies at its start.
+            size_t const full = empty[0];
+            if (!empty[full]) {
+                size_t offset = 0;
 #if UINT32
-            if ((uintptr_t)&out[borders[I]] & DMA_OFF_MASK) {
-                atomic_write(&out[borders[I]], *starts[1]);
-                offset = 1;
-            }
+                if ((uintptr_t)&out[borders[I]] & DMA_OFF_MASK) {
+                    atomic_write(&out[borders[I]], *starts[full]);
+                    offset = 1;
+                }
 #endif  // UINT32
-            flush_run(starts[1] + offset, ends[1], &out[borders[I] + offset]);
+                flush_run(starts[full] + offset, ends[full], &out[borders[I] + offset]);
+            }
         } else {
 #if STABLE
             if (starts[0] > starts[1]) {
@@ -190,53 +295,44 @@ static __attribute__((unused)) void merge_par(void) {
                 ends[1] = temp;
             }
 #endif  // STABLE
+#if CUSTOM_READER
+            reset_reader(&readers[0], starts[0], ends[0]);
+            reset_reader(&readers[1], starts[1], ends[1]);
+            merge_mram_custom(readers, &out[borders[I]]);
+#else
             T *ptr[2] = {
-                sr_init(wram[0], starts[0], &sr[I][0]),
-                sr_init(wram[1], starts[1], &sr[I][1]),
+                sr_init(wram[0], starts[0], &sr[I][0], ends[0]),
+                sr_init(wram[1], starts[1], &sr[I][1], ends[1]),
             };
             merge_mram(ptr, ends, &out[borders[I]], wram);
+#endif
         }
         flipped[I] = !flipped[I];
-        // Now, I need to calculate the boundaries of the sorted run of my subtree.
-        // The root wrote to the head, the rightmost leaf to the tail.
-        if (!(I & ((1 << round) - 1))) {  // Am I the root?
-            from[I][0].start = borders[I];
-            sysname_t const rightmost_leaf = I | ((1 << round) - 1);
-            handshake_wait_for(rightmost_leaf);
-            size_t const length = from[rightmost_leaf][0].end - from[rightmost_leaf][0].start + 1 +
-                    from[rightmost_leaf][1].end - from[rightmost_leaf][1].start + 1;
-            from[I][0].end = borders[rightmost_leaf] + length - 1;
-        } else if ((I & ((1 << round) - 1)) == ((1 << round) - 1)) {  // Am I the rightmost leaf?
-            handshake_notify();
-        }
+        // The boundaries of the sorted run of my subtree are calculated by the root of the next
+        // round once all of its tasklets are done with merging. The leaf must not notify the root
+        // since, if the root finished merging before the leaf was awoken, the root would consume
+        // the notification with which the leaf asked to be awoken.
     }
 }
 
 /**
- * @brief Forms `NR_TASKLETS` starting runs, ensures that everything is within the same array and,
- * then, merges in parallel.
+ * @brief Forms `NR_TASKLETS` sorted runs, all within the same array, and, then, merges in parallel.
  * 
  * @param start The first element to sort by the calling tasklet.
  * @param end The last element to sort by the calling tasklet.
 **/
 static void merge_sort_par(T __mram_ptr * const start, T __mram_ptr * const end) {
-    merge_sort_mram(start, end);
 #if (NR_TASKLETS > 1)
-    if (me() == NR_TASKLETS - 2) {
-        handshake_notify();
-        handshake_wait_for(me() + 1);
-    } else if (me() == NR_TASKLETS - 1) {
-        handshake_wait_for(me() - 1);
-        if (flipped[me() - 1] != flipped[me()]) {
-            T __mram_ptr *in = (flipped[me()]) ? output : input;
-            T __mram_ptr *out = (flipped[me()]) ? input : output;
-            copy_run(&in[from[me()][0].start], &in[from[me()][0].end], &out[from[me()][0].start]);
-            flipped[me()] = !flipped[me()];
-        }
-        handshake_notify();
-    }
+    // All runs must end up in the same array, namely that where the first tasklet, whose run is
+    // merged most often, gets by itself. A shorter part may need a different number of passes,
+    // and a run merged once less has to start in the other array.
+    bool const into_output = (merge_passes(host_to_dpu.part_length, shared_run_length(0)) & 1)
+            ^ ((leaf_depth(0) - leaf_depth(me())) & 1);
+    merge_sort_mram_into(start, end, into_output);
     borders[me()] = from[me()][0].start;
     merge_par();
+#else
+    merge_sort_mram(start, end);
 #endif  // NR_TASKLETS > 1
 }
 
@@ -261,6 +357,7 @@ int main(void) {
                 DMA_ALIGNED(DIV_CEIL(host_to_dpu.length, NR_TASKLETS) * sizeof(T)) / sizeof(T);
         host_to_dpu.basic_seed = 0b1011100111010;
         host_to_dpu.algo_index = 0;
+        host_to_dpu.active_tasklets = NR_TASKLETS;
         input_rngs[me()] = seed_xs(host_to_dpu.basic_seed + me());
         mram_range range = { 0, host_to_dpu.length * host_to_dpu.reps };
         generate_uniform_distribution_mram(input, cache, &range, 8);
@@ -268,16 +365,24 @@ int main(void) {
     barrier_wait(&omni_barrier);
 
     /* Perform test. */
-    mram_range range = {
-        me() * host_to_dpu.part_length,
-        (me() == NR_TASKLETS - 1) ? host_to_dpu.offset : (me() + 1) * host_to_dpu.part_length,
+    sysname_t const active = host_to_dpu.active_tasklets;
+    mram_range range = {  // Parked tasklets and those past the input get empty parts at the end.
+        (me() < active)
+                ? MIN(me() * host_to_dpu.part_length, host_to_dpu.offset)
+                : host_to_dpu.offset,
+        (me() + 1 < active)
+                ? MIN((me() + 1) * host_to_dpu.part_length, host_to_dpu.offset)
+                : host_to_dpu.offset,
     };
-    from[me()][0].start = range.start, from[me()][0].end = range.end - 1;
     sort_algo_mram * const algo = algos[host_to_dpu.algo_index].data.fct.mram;
     memset(&dpu_to_host, 0, sizeof dpu_to_host);
+    dpu_to_host.sorted_parts = 1;
+    dpu_to_host.sorted_length = host_to_dpu.offset;
+    dpu_to_host.starting_run_length = shared_run_length(0);
 
     for (uint32_t rep = 0; rep < host_to_dpu.reps; rep++) {
         pivot_rngs[me()] = seed_xs_offset(host_to_dpu.basic_seed + me());
+        from[me()][0].start = range.start, from[me()][0].end = range.end - 1;  // Changed by merging.
 
         get_stats_unsorted(input, cache, range, false, &stats_before);
 
@@ -291,13 +396,14 @@ int main(void) {
         if (me() == 0) {
             for (size_t i = 1; i < NR_TASKLETS; i++)
                 times[0] = (times[i] > times[0]) ? times[i] : times[0];
-            dpu_to_host.firsts += times[0];
-            dpu_to_host.seconds += times[0] * times[0];
+            dpu_to_host.times[rep] = times[0];
+            // All tasklets end up in the same array, and each sets `flipped` anew when sorting.
+            dpu_to_host.parts_in_output = flipped[0];
         }
 
         T __mram_ptr *sorted_array = (flipped[me()]) ? output : input;
-        flipped[me()] = false;
-        get_stats_sorted(sorted_array, cache, range, false, &stats_after);
+        get_stats_sorted(sorted_array, cache, range, false, dpu_to_host.sorted_parts == 1,
+                &stats_after);
         if (compare_stats(&stats_before, &stats_after, false) == EXIT_FAILURE) {
             abort();
         }
@@ -203,6 +203,31 @@ static inline void copy_full_run(T *in, T *until, T *out) {
 **/
 #define UNROLL_FACTOR (MIN(MERGE_THRESHOLD, 16))
 
+/**
+ * @brief Writes the lesser current item of the two runs to `out[k]` and advances its run.
+ * If `branchless` is set, the item is selected through arithmetic masking
+ * and both runs are advanced by the outcome of the comparison,
+ * so no jump depends on the data. In return, both current items are reloaded.
+ *
+ * @param k The offset from `out` whither to write.
+**/
+#define MERGE_STEP(k)                                \
+if (branchless) {                                    \
+    size_t const take_j = val_j < val_i;             \
+    T const mask = (T)0 - (T)take_j;                 \
+    *(out + (k)) = (val_i & ~mask) | (val_j & mask); \
+    i += 1 - take_j;                                 \
+    j += take_j;                                     \
+    val_i = *i;                                      \
+    val_j = *j;                                      \
+} else if (val_i <= val_j) {                         \
+    *(out + (k)) = val_i;                            \
+    val_i = *++i;                                    \
+} else {                                             \
+    *(out + (k)) = val_j;                            \
+    val_j = *++j;                                    \
+}
+
 /**
  * @brief Merges the two runs within the merger functions in unrolled loops.
  * 
@@ -214,13 +239,7 @@ static inline void copy_full_run(T *in, T *until, T *out) {
 while (ptr <= end - UNROLL_FACTOR + 1) {             \
     _Pragma("unroll")                                \
     for (size_t k = 0; k < UNROLL_FACTOR; k++) {     \
-        if (val_i <= val_j) {                        \
-            *(out + k) = val_i;                      \
-            val_i = *++i;                            \
-        } else {                                     \
-            *(out + k) = val_j;                      \
-            val_j = *++j;                            \
-        }                                            \
+        MERGE_STEP(k);                               \
     }                                                \
     out += UNROLL_FACTOR;                            \
 };                                                   \
@@ -228,13 +247,7 @@ on_depletion                                         \
 while (ptr <= end - (UNROLL_FACTOR / 2) + 1) {       \
     _Pragma("unroll")                                \
     for (size_t k = 0; k < UNROLL_FACTOR / 2; k++) { \
-        if (val_i <= val_j) {                        \
-            *(out + k) = val_i;                      \
-            val_i = *++i;                            \
-        } else {                                     \
-            *(out + k) = val_j;                      \
-            val_j = *++j;                            \
-        }                                            \
+        MERGE_STEP(k);                               \
     }                                                \
     out += UNROLL_FACTOR / 2;                        \
 }                                                    \
@@ -249,8 +262,10 @@ on_depletion
  * @param start_2 The first element of the second run. Must follow the end of the first run.
  * @param end_2 The last element of the second run.
  * @param out Whither the merged runs are written.
+ * @param branchless Whether the unrolled loops use branchless merge steps.
 **/
-static inline void merge(T * const start_1, T * const start_2, T * const end_2, T *out) {
+static __attribute__((always_inline)) inline void merge(T * const start_1, T * const start_2,
+        T * const end_2, T *out, bool const branchless) {
     T *i = start_1, *j = start_2;
     T val_i = *i, val_j = *j;
     if (*(start_2 - 1) <= *(end_2)) {
@@ -295,8 +310,10 @@ static inline void merge(T * const start_1, T * const start_2, T * const end_2,
  * 
  * @param start The first element of the WRAM array to sort.
  * @param end The last element of said array.
+ * @param branchless Whether the merges use branchless merge steps.
 **/
-static inline void merge_sort_no_write_back(T * const start, T * const end) {
+static __attribute__((always_inline)) inline void merge_sort_full_space_with(T * const start,
+        T * const end, bool const branchless) {
     /* Starting runs. */
     FORM_STARTING_RUNS_RIGHT2LEFT();
 
@@ -319,13 +336,14 @@ static inline void merge_sort_no_write_back(T * const start, T * const end) {
         T *run_1_end = until - run_length;
         for (; (intptr_t)run_1_end >= (intptr_t)(in + run_length - 1); run_1_end -= 2*run_length) {
             out -= 2*run_length;
-            merge(run_1_end + 1 - run_length, run_1_end + 1, run_1_end + run_length, out);
+            merge(run_1_end + 1 - run_length, run_1_end + 1, run_1_end + run_length, out,
+                    branchless);
         }
         // Merge pair at the beginning where the first run is shorter.
         if ((intptr_t)run_1_end >= (intptr_t)in) {
             size_t const run_1_length = run_1_end + 1 - in;
             out -= run_length + run_1_length;
-            merge(in, run_1_end + 1, run_1_end + run_length, out);
+            merge(in, run_1_end + 1, run_1_end + run_length, out, branchless);
         // Flush single run at the beginning straight away
         } else if ((intptr_t)(run_1_end + run_length) >= (intptr_t)in) {
             out = (flip) ? end + 1 : start;
@@ -335,6 +353,32 @@ static inline void merge_sort_no_write_back(T * const start, T * const end) {
     flipped[me()] = flip;
 }
 
+/**
+ * @brief An implementation of standard MergeSort.
+ * @note This function saves up to `n` elements after the end of the input array.
+ * For speed reasons, the sorted array may be stored after that very end.
+ * In other words, the sorted array is not written back to the start of the input array.
+ * 
+ * @param start The first element of the WRAM array to sort.
+ * @param end The last element of said array.
+**/
+static void merge_sort_no_write_back(T * const start, T * const end) {
+    merge_sort_full_space_with(start, end, false);
+}
+
+/**
+ * @brief An implementation of MergeSort whose unrolled merge loops are branchless.
+ * @note This function saves up to `n` elements after the end of the input array.
+ * For speed reasons, the sorted array may be stored after that very end.
+ * In other words, the sorted array is not written back to the start of the input array.
+ * 
+ * @param start The first element of the WRAM array to sort.
+ * @param end The last element of said array.
+**/
+static void merge_sort_branchless(T * const start, T * const end) {
+    merge_sort_full_space_with(start, end, true);
+}
+
 /**
  * @brief An implementation of standard MergeSort.
  * @note This function saves up to `n` elements after the end of the input array.
@@ -362,9 +406,10 @@ static void merge_sort_write_back(T * const start, T * const end) {
  * @param end_2 The last element of the second run.
  * @param out Whither the merged runs are written.
  * Must be equal to `start_1` - (`end_2` - `start_2` + 1).
+ * @param branchless Whether the unrolled loops use branchless merge steps.
 **/
-static inline void merge_right_flush_only(T * const start_1, T * const end_1, T * const start_2,
-        T * const end_2, T *out) {
+static __attribute__((always_inline)) inline void merge_right_flush_only(T * const start_1,
+        T * const end_1, T * const start_2, T * const end_2, T *out, bool const branchless) {
     T *i = start_1, *j = start_2;
     T val_i = *i, val_j = *j;
     if (*end_1 <= *end_2) {
@@ -406,8 +451,10 @@ static inline void merge_right_flush_only(T * const start_1, T * const end_1, T
  * 
  * @param start The first element of the WRAM array to sort.
  * @param end The last element of said array.
+ * @param branchless Whether the merges use branchless merge steps.
 **/
-static void merge_sort_half_space(T * const start, T * const end) {
+static __attribute__((always_inline)) inline void merge_sort_half_space_with(T * const start,
+        T * const end, bool const branchless) {
     /* Starting runs. */
     FORM_STARTING_RUNS_RIGHT2LEFT();
 
@@ -434,16 +481,44 @@ static void merge_sort_half_space(T * const start, T * const end) {
                 end + run_1_length,
                 run_1_end + 1,
                 run_1_end + run_length,
-                run_1_start
+                run_1_start,
+                branchless
             );
         }
     }
 }
 
+/**
+ * @brief An implementation of MergeSort that only uses `n`/2 additional space.
+ * @note This function saves up to `n`/2 elements after the end of the input array.
+ * The sorted array is always stored from `start` to `end`.
+ * 
+ * @param start The first element of the WRAM array to sort.
+ * @param end The last element of said array.
+**/
+static void merge_sort_half_space(T * const start, T * const end) {
+    merge_sort_half_space_with(start, end, false);
+}
+
+/**
+ * @brief An implementation of MergeSort that only uses `n`/2 additional space
+ * and whose unrolled merge loops are branchless.
+ * @note This function saves up to `n`/2 elements after the end of the input array.
+ * The sorted array is always stored from `start` to `end`.
+ * 
+ * @param start The first element of the WRAM array to sort.
+ * @param end The last element of said array.
+**/
+static void merge_sort_half_space_branchless(T * const start, T * const end) {
+    merge_sort_half_space_with(start, end, true);
+}
+
 union algo_to_test __host algos[] = {
     {{ "Merge", { .wram = merge_sort_no_write_back }}},
     {{ "MergeWriteBack", { .wram = merge_sort_write_back } }},
     {{ "MergeHalfSpace", { .wram = merge_sort_half_space } }},
+    {{ "MergeBranchless", { .wram = merge_sort_branchless } }},
+    {{ "HalfBranchless", { .wram = merge_sort_half_space_branchless } }},
 };
 size_t __host num_of_algos = sizeof algos / sizeof algos[0];
 
@@ -478,6 +553,8 @@ int main(void) {
     unsigned int const transfer_size = DMA_ALIGNED(sizeof(T[host_to_dpu.length]));
     sort_algo_wram * const algo = algos[host_to_dpu.algo_index].data.fct.wram;
     memset(&dpu_to_host, 0, sizeof dpu_to_host);
+    dpu_to_host.sorted_parts = 1;
+    dpu_to_host.sorted_length = host_to_dpu.length;
 
     for (uint32_t rep = 0; rep < host_to_dpu.reps; rep++) {
         pivot_rngs[me()] = seed_xs_offset(host_to_dpu.basic_seed + me());
@@ -490,8 +567,7 @@ int main(void) {
         dpu_time new_time = perfcounter_get();
         algo(start, end);
         new_time = perfcounter_get() - new_time - CALL_OVERHEAD;
-        dpu_to_host.firsts += new_time;
-        dpu_to_host.seconds += new_time * new_time;
+        dpu_to_host.times[rep] = new_time;
 
         size_t offset = 0;  // Needed because of the MergeSort not writing back.
         if (flipped[me()]) {
@@ -504,6 +580,11 @@ int main(void) {
         if (compare_stats(&stats_before, &stats_after, false) == EXIT_FAILURE) {
             abort();
         }
+        if (host_to_dpu.write_back) {  // Let the host verify the sorted data.
+            if (offset != 0)  // The DMA needs an aligned WRAM address.
+                memcpy(cache, cache + offset, sizeof(T[host_to_dpu.length]));
+            mram_write_triple(cache, read_from, transfer_size);
+        }
 
         read_from += host_to_dpu.offset;
         host_to_dpu.basic_seed += NR_TASKLETS;
@@ -415,6 +415,8 @@ int main(void) {
     unsigned int const transfer_size = DMA_ALIGNED(sizeof(T[host_to_dpu.length]));
     sort_algo_wram * const algo = algos[host_to_dpu.algo_index].data.fct.wram;
     memset(&dpu_to_host, 0, sizeof dpu_to_host);
+    dpu_to_host.sorted_parts = 1;
+    dpu_to_host.sorted_length = host_to_dpu.length;
 
     for (uint32_t rep = 0; rep < host_to_dpu.reps; rep++) {
         pivot_rngs[me()] = seed_xs_offset(host_to_dpu.basic_seed + me());
@@ -427,14 +429,16 @@ int main(void) {
         dpu_time new_time = perfcounter_get();
         algo(start, end);
         new_time = perfcounter_get() - new_time - CALL_OVERHEAD;
-        dpu_to_host.firsts += new_time;
-        dpu_to_host.seconds += new_time * new_time;
+        dpu_to_host.times[rep] = new_time;
 
         array_stats stats_after;
         get_stats_sorted_wram(cache, host_to_dpu.length, &stats_after);
         if (compare_stats(&stats_before, &stats_after, false) == EXIT_FAILURE) {
             abort();
         }
+        if (host_to_dpu.write_back) {  // Let the host verify the sorted data.
+            mram_write_triple(cache, read_from, transfer_size);
+        }
 
         read_from += host_to_dpu.offset;
         host_to_dpu.basic_seed += NR_TASKLETS;
@@ -228,6 +228,27 @@ static __attribute__((unused)) void shell_sort_ciura(T * const start, T * const
     insertion_sort_sentinel(start, end);
 }
 
+#if (BIG_STEP > 0)
+
+/**
+ * @brief The first round of a three-tier ShellSort, which is only done
+ * if `BIG_STEP` is bigger than the given step size.
+ * 
+ * @param step The step size of the second round.
+**/
+#define SHELL_SORT_BIG_STEP_ROUND(step)                                 \
+if (BIG_STEP > step) {                                                  \
+    _Pragma("nounroll")  /* The .text region may overflow otherwise. */ \
+    for (size_t j = 0; j < BIG_STEP; j++)                               \
+        insertion_sort_with_steps_sentinel(&start[j], end, BIG_STEP);   \
+}
+
+#else
+
+#define SHELL_SORT_BIG_STEP_ROUND(step)
+
+#endif  // BIG_STEP > 0
+
 /**
  * @brief Creates a ShellSort of the name `shell_sort_custom_step_x`
  * with `x` ∈ {2, …, 9} being the step size before the final InsertionSort.
@@ -240,11 +261,7 @@ static __attribute__((unused)) void shell_sort_ciura(T * const start, T * const
 **/
 #define SHELL_SORT_CUSTOM_STEP_X(step)                                      \
 static void shell_sort_custom_step_##step(T * const start, T * const end) { \
-    if (BIG_STEP > step) {                                                  \
-        _Pragma("nounroll")  /* The .text region may overflow otherwise. */ \
-        for (size_t j = 0; j < BIG_STEP; j++)                               \
-            insertion_sort_with_steps_sentinel(&start[j], end, BIG_STEP);   \
-    }                                                                       \
+    SHELL_SORT_BIG_STEP_ROUND(step);                                        \
     for (size_t j = 0; j < step; j++)                                       \
         insertion_sort_with_steps_sentinel(&start[j], end, step);           \
     insertion_sort_sentinel(start, end);                                    \
@@ -314,6 +331,8 @@ int main(void) {
     unsigned int const transfer_size = DMA_ALIGNED(sizeof(T[host_to_dpu.length]));
     sort_algo_wram * const algo = algos[host_to_dpu.algo_index].data.fct.wram;
     memset(&dpu_to_host, 0, sizeof dpu_to_host);
+    dpu_to_host.sorted_parts = 1;
+    dpu_to_host.sorted_length = host_to_dpu.length;
 
     for (uint32_t rep = 0; rep < host_to_dpu.reps; rep++) {
         pivot_rngs[me()] = seed_xs_offset(host_to_dpu.basic_seed + me());
@@ -326,14 +345,16 @@ int main(void) {
         dpu_time new_time = perfcounter_get();
         algo(start, end);
         new_time = perfcounter_get() - new_time - CALL_OVERHEAD;
-        dpu_to_host.firsts += new_time;
-        dpu_to_host.seconds += new_time * new_time;
+        dpu_to_host.times[rep] = new_time;
 
         array_stats stats_after;
         get_stats_sorted_wram(cache, host_to_dpu.length, &stats_after);
         if (compare_stats(&stats_before, &stats_after, false) == EXIT_FAILURE) {
             abort();
         }
+        if (host_to_dpu.write_back) {  // Let the host verify the sorted data.
+            mram_write_triple(cache, read_from, transfer_size);
+        }
 
         read_from += host_to_dpu.offset;
         host_to_dpu.basic_seed += NR_TASKLETS;
@@ -27,6 +27,7 @@ ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
 SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 */
 
+#include <assert.h>
 #include <atomic_bit.h>
 #include <dpuruntime.h>
 
@@ -48,25 +49,42 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #endif
 
+#ifndef WRAM_HEAP_END
+/// @brief The first address after the WRAM heap, which extends up to the end of the 64-KiB WRAM.
+/// The native build overrides it with the end of its emulated WRAM.
+#define WRAM_HEAP_END (64 * 1024)
+#endif
+
 extern void *mem_alloc_nolock(size_t size);
 ATOMIC_BIT_EXTERN(__heap_pointer);
 
+/// @brief The size of the arena of each tasklet. Set by the first tasklet to allocate its arena.
+static size_t arena_size;
 
 void allocate_triple_buffer(triple_buffers *buffers) {
     ATOMIC_BIT_ACQUIRE(__heap_pointer);
 
-    // Initialise a local cache to store one MRAM block.
-    T *cache = mem_alloc_nolock(CACHE_SIZE);
-
-    // Initialise the buffers for the two sequential readers.
-    uintptr_t heap_pointer = (uintptr_t)__HEAP_POINTER;
-    uintptr_t seqs = (heap_pointer + PAGE_OFF_MASK) & PAGE_IDX_MASK;
-    size_t size = seqs + 2 * PAGE_ALLOC_SIZE - heap_pointer;
-    mem_alloc_nolock(size);
+    // Split the free heap evenly, with each arena starting at a page boundary.
+    if (arena_size == 0) {
+        uintptr_t const heap_pointer = (uintptr_t)__HEAP_POINTER;
+        uintptr_t const first_arena = (heap_pointer + PAGE_OFF_MASK) & PAGE_IDX_MASK;
+        if (first_arena != heap_pointer)
+            mem_alloc_nolock(first_arena - heap_pointer);
+        size_t const min_size =
+                ((CACHE_SIZE + PAGE_OFF_MASK) & PAGE_IDX_MASK) + 2 * PAGE_ALLOC_SIZE;
+        size_t const share = ((WRAM_HEAP_END - first_arena) / NR_TASKLETS) & PAGE_IDX_MASK;
+        arena_size = (share > min_size) ? share : min_size;
+        // Arenas of `min_size` bytes may not fit, for example with a large `CACHE_SIZE`.
+        assert(first_arena + NR_TASKLETS * arena_size <= WRAM_HEAP_END
+                && "The arenas of all tasklets do not fit into the WRAM!");
+    }
+    uintptr_t const arena = (uintptr_t)mem_alloc_nolock(arena_size);
 
     ATOMIC_BIT_RELEASE(__heap_pointer);
 
-    buffers->cache = cache;
-    buffers->seq_1 = seqs;
-    buffers->seq_2 = seqs + PAGE_ALLOC_SIZE;
+    // The cache takes up everything before the buffers for the two sequential readers.
+    buffers->cache = (T *)arena;
+    buffers->seq_1 = arena + arena_size - 2 * PAGE_ALLOC_SIZE;
+    buffers->seq_2 = arena + arena_size - PAGE_ALLOC_SIZE;
+    buffers->size = arena_size;
 }
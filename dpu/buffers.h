@@ -7,61 +7,86 @@
  * up until the end of the second sequential-read buffer, no other tasklet stores anything.
  * Thus, if the sequential-read buffers are not needed, they too can be used for general purposes.
  * The cache then has a size of `CACHE_SIZE` + 4 × `SEQREAD_CACHE_SIZE`.
+ *
+ * In fact, the free WRAM heap is split evenly among all tasklets into arenas.
+ * The cache starts at the beginning of an arena and the two sequential-read buffers end it,
+ * so the cache grows with all WRAM no one else needs.
+ * Each phase of a sort lays out the arena anew: the formation of starting runs uses all of it
+ * (save for the call stack of QuickSort at its end),
+ * whereas merging uses the readers and the cache.
 **/
 
 #ifndef _BUFFERS_H_
 #define _BUFFERS_H_
 
 #include <stddef.h>
+#include <stdint.h>
 
+#include <defs.h>
 #include <mram.h>
 #include <memmram_utils.h>
 #include <seqread.h>
 
+#include "buffer_sizes.h"
 #include "common.h"
 
-/// @brief The minimum size of a general-purpose buffer & two sequential-reader buffers.
-#define TRIPLE_BUFFER_SIZE ((CACHE_SIZE + 4 * SEQREAD_CACHE_SIZE) & ~DMA_OFF_MASK)
-/// @brief The min. number of elements in a general-purpose buffer & two sequential-reader buffers.
-#define TRIPLE_BUFFER_LENGTH (TRIPLE_BUFFER_SIZE >> DIV)
-/// @brief The maximum number of bytes transferable at once between MRAM and a triple buffer.
-#define MAX_TRANSFER_SIZE_TRIPLE (((TRIPLE_BUFFER_SIZE > 2048) ? 2048 : TRIPLE_BUFFER_SIZE) \
-        & ~DMA_OFF_MASK)
-/// @brief The maximum number of elements transferable at once between MRAM and a triple buffer.
-#define MAX_TRANSFER_LENGTH_TRIPLE (MAX_TRANSFER_SIZE_TRIPLE >> DIV)
-/// @brief The maximum number of bytes transferable at once between MRAM and the cache.
-#define MAX_TRANSFER_SIZE_CACHE (((CACHE_SIZE > 2048) ? 2048 : CACHE_SIZE) & ~DMA_OFF_MASK)
-/// @brief The maximum number of elements transferable at once between MRAM and the cache.
-#define MAX_TRANSFER_LENGTH_CACHE (MAX_TRANSFER_SIZE_CACHE >> DIV)
-/// @brief How much space is needed by sentinels.
-#define SENTINELS_SIZE (DMA_ALIGNED(1 << DIV))
-/// @brief How many sentinels there are (e.g. 2 for 32-bit integers, 1 for 64-bit integers).
-#define SENTINELS_NUMS (SENTINELS_SIZE >> DIV)
-
 /**
  * @brief Holds the WRAM addresses of one general-purpose buffer and two sequential-read buffers.
  * They are contiguous so they can be seen as a single buffer,
- * ranging from `&cache[0]` to `&cache[TRIPLE_BUFFER_SIZE]`.
+ * ranging from `&cache[0]` to `&cache[size]`, which is at least `TRIPLE_BUFFER_SIZE` bytes long.
 **/
 typedef struct triple_buffers {
-    /// @brief The general-purpose buffer of size `CACHE_SIZE`.
+    /// @brief The general-purpose buffer of size `CACHE_SIZE` or more.
     T *cache;
     /// @brief The first buffer for some sequential reader.
     seqreader_buffer_t seq_1;
     /// @brief The second buffer for some sequential reader.
     seqreader_buffer_t seq_2;
+    /// @brief The size of the whole arena in bytes, starting at `cache`.
+    size_t size;
 } triple_buffers;
 
+extern triple_buffers buffers[NR_TASKLETS];
+
 /**
- * @brief Allocates contiguous memory for general-purpose buffer and two sequential-reader buffers.
- * @note It is advisable not to call `mem_alloc`
- * as long as not all tasklets have allocated their triple buffer.
- * Otherwise, the rounding this function does can lead to siginificant waste of memory space.
+ * @brief Allocates the arena of a tasklet, which holds a general-purpose buffer
+ * and two sequential-reader buffers.
+ * The first tasklet to call this function splits the free WRAM heap evenly among all tasklets.
+ * @note All tasklets must allocate their arena before anything else is allocated on the heap.
+ * Afterwards, the heap is exhausted.
  * 
  * @param buffers The struct where the addresses are stored.
 **/
 void allocate_triple_buffer(triple_buffers *buffers);
 
+/**
+ * @brief Returns the end of the arena of the current tasklet.
+ * 
+ * @return The first address after the arena.
+**/
+static inline void *arena_end(void) {
+    return (uint8_t *)buffers[me()].cache + buffers[me()].size;
+}
+
+/**
+ * @brief Computes how many bytes of a page are worth loading when reading a run.
+ * Since nothing beyond the last item of the run is read,
+ * short runs and the ends of long ones get smaller DMAs than a full page.
+ *
+ * @param from The first MRAM address to load. Must be DMA-aligned.
+ * @param to The last item of the run.
+ * @param page_size The size of a full page.
+ *
+ * @return The size of the DMA, from `DMA_ALIGNMENT` to `page_size`.
+**/
+static inline size_t run_load_size(uintptr_t const from, T __mram_ptr const * const to,
+        size_t const page_size) {
+    intptr_t const needed = (intptr_t)(to + 1) - (intptr_t)from;
+    if (needed >= (intptr_t)page_size)
+        return page_size;
+    return (needed > DMA_ALIGNMENT) ? DMA_ALIGNED(needed) : DMA_ALIGNMENT;
+}
+
 /**
  * @brief Stores the specified number of bytes from MRAM to a triple buffer in WRAM.
  * 
@@ -14,6 +14,7 @@
 #define NR_COUNTS (sizeof(((array_stats *)0)->counts) / sizeof(((array_stats *)0)->counts[0]))
 
 uint64_t sums[NR_TASKLETS];
+uint64_t fingerprints[NR_TASKLETS];
 size_t counts[NR_TASKLETS][NR_COUNTS];
 bool unsorted[NR_TASKLETS];
 
@@ -48,10 +49,38 @@ void print_single_line(T *cache, size_t length) {
     mutex_unlock(printing_mutex);
 }
 
+/**
+ * @brief Resets the statistics of the calling tasklet.
+**/
+static inline void reset_stats(void) {
+    fingerprints[me()] = 0;
+#if (CHECK_SANITY)
+    sums[me()] = 0;
+    for (size_t i = 0; i < NR_COUNTS; i++) {
+        counts[me()][i] = 0;
+    }
+    unsorted[me()] = false;
+#endif  // CHECK_SANITY
+}
+
+/**
+ * @brief Adds an element to the statistics of the calling tasklet.
+ * Only the fingerprint is kept in release builds, the sum and the counts only with `CHECK_SANITY`.
+ * 
+ * @param value The element to add.
+**/
+static inline void add_to_stats(T const value) {
+    fingerprints[me()] += hash_key(value);
 #if (CHECK_SANITY)
+    sums[me()] += value;
+    if (value < NR_COUNTS) {
+        counts[me()][value]++;
+    }
+#endif  // CHECK_SANITY
+}
 
 /**
- * @brief Reduces `sums`, `counts`, and `unsorted`.
+ * @brief Reduces `fingerprints`, `sums`, `counts`, and `unsorted`.
  * 
  * @param dummy Whether a dummy value was set.
  * @param result The struct where the results are stored.
@@ -60,35 +89,37 @@ static void accumulate_stats(bool dummy, array_stats *result) {
     if (me() != 0) return;
     // Gather statistics.
     for (size_t t = 1; t < NR_TASKLETS; t++) {
+        fingerprints[0] += fingerprints[t];
+#if (CHECK_SANITY)
         sums[0] += sums[t];
         for (size_t j = 0; j < NR_COUNTS; j++) {
             counts[0][j] += counts[t][j];
         }
         unsorted[0] |= unsorted[t];
+#endif  // CHECK_SANITY
     }
     // Write statistics onto the appropriate memory address.
+    // The dummy value is at the end of the last range.
+    result->fingerprint = fingerprints[0];
+    result->fingerprint -= (dummy) ? hash_key(UINT32_MAX) : 0;
+#if (CHECK_SANITY)
     result->sum = sums[0];
-    result->sum -= (dummy) ? UINT32_MAX : 0;  // The dummy value is at the end of the last range.
+    result->sum -= (dummy) ? UINT32_MAX : 0;
     memcpy(&result->counts, counts[0], NR_COUNTS * sizeof(counts[0][0]));
     result->unsorted = unsorted[0];
+#endif  // CHECK_SANITY
 }
 
 void get_stats_unsorted(T __mram_ptr const * const array, T * const cache, mram_range const range,
         bool const dummy, array_stats * const result) {
-    // Reset values.
-    sums[me()] = 0;
-    for (size_t i = 0; i < NR_COUNTS; i++) {
-        counts[me()][i] = 0;
-    }
+    barrier_wait(&checking_barrier);  // Tasklet 0 may still be reducing the last statistics.
+    reset_stats();
     // Calculate statistics.
     size_t i, curr_length, curr_size;
     LOOP_ON_MRAM(i, curr_length, curr_size, range) {
         mram_read(&array[i], cache, curr_size);
         for (size_t j = 0; j < curr_length; j++) {
-            sums[me()] += cache[j];
-            if (cache[j] < NR_COUNTS) {
-                counts[me()][cache[j]]++;
-            }
+            add_to_stats(cache[j]);
         }
     }
     barrier_wait(&checking_barrier);
@@ -96,85 +127,71 @@ void get_stats_unsorted(T __mram_ptr const * const array, T * const cache, mram_
 }
 
 void get_stats_sorted(T __mram_ptr const * const array, T * const cache, mram_range const range,
-        bool const dummy, array_stats * const result) {
-    // Reset values.
-    sums[me()] = 0;
-    for (size_t i = 0; i < NR_COUNTS; i++) {
-        counts[me()][i] = 0;
-    }
-    unsorted[me()] = false;
-    T prev = (me() == 0) ? T_MIN : array[range.start-1];
+        bool const dummy, bool const single_part, array_stats * const result) {
+    barrier_wait(&checking_barrier);  // Tasklet 0 may still be reducing the last statistics.
+    reset_stats();
+#if (CHECK_SANITY)
+    // The range of tasklet 0 starts a new repetition, the others continue the preceding range.
+    T prev = (single_part && me() != 0) ? array[range.start-1] : T_MIN;
+#else  // CHECK_SANITY
+    (void)single_part;
+#endif  // CHECK_SANITY
     // Calculate statistics and check order.
     size_t i, curr_length, curr_size;
     LOOP_ON_MRAM_BL(i, curr_length, curr_size, range, MAX_TRANSFER_LENGTH_TRIPLE - SENTINELS_NUMS) {
         mram_read(&array[i], cache, curr_size);
-        unsorted[me()] |= (prev > cache[0]);
-        sums[me()] += cache[0];
-        if (cache[0] < NR_COUNTS) {
-            counts[me()][cache[0]]++;
+        for (size_t j = 0; j < curr_length; j++) {
+            add_to_stats(cache[j]);
         }
+#if (CHECK_SANITY)
+        unsorted[me()] |= (prev > cache[0]);
         for (size_t j = 1; j < curr_length; j++) {
-            sums[me()] += cache[j];
-            if (cache[j] < NR_COUNTS) {
-                counts[me()][cache[j]]++;
-            }
             unsorted[me()] |= (cache[j-1] > cache[j]);
         }
         prev = cache[MAX_TRANSFER_LENGTH_TRIPLE - SENTINELS_NUMS - 1];
+#endif  // CHECK_SANITY
     }
     barrier_wait(&checking_barrier);
     accumulate_stats(dummy, result);
 }
 
 void get_stats_unsorted_wram(T const array[], size_t const length, array_stats *result) {
-    // Reset values.
-    sums[me()] = 0;
-    for (size_t i = 0; i < NR_COUNTS; i++) {
-        counts[me()][i] = 0;
-    }
+    reset_stats();
     // Calculate statistics.
     for (size_t j = 0; j < length; j++) {
-        sums[me()] += array[j];
-        if (array[j] < NR_COUNTS) {
-            counts[me()][array[j]]++;
-        }
+        add_to_stats(array[j]);
     }
     accumulate_stats(false, result);
 }
 
 void get_stats_sorted_wram(T const array[], size_t const length, array_stats *result) {
-    // Reset values.
-    sums[me()] = 0;
-    for (size_t i = 0; i < NR_COUNTS; i++) {
-        counts[me()][i] = 0;
-    }
-    unsorted[me()] = false;
+    reset_stats();
     // Calculate statistics and check order.
-    sums[me()] += array[0];
-    if (array[0] < NR_COUNTS) {
-        counts[me()][array[0]]++;
+    for (size_t j = 0; j < length; j++) {
+        add_to_stats(array[j]);
     }
+#if (CHECK_SANITY)
     for (size_t j = 1; j < length; j++) {
-        sums[me()] += array[j];
-        if (array[j] < NR_COUNTS) {
-            counts[me()][array[j]]++;
-        }
         unsorted[me()] |= (array[j-1] > array[j]);
     }
+#endif  // CHECK_SANITY
     accumulate_stats(false, result);
 }
 
 bool compare_stats(array_stats const * const stats_1, array_stats const * const stats_2,
         bool const print_on_success) {
     if (me() != 0) return EXIT_SUCCESS;
-    bool same_elements = (stats_1->sum == stats_2->sum);
+#if (CHECK_SANITY)
+    bool same_elements = (stats_1->fingerprint == stats_2->fingerprint);
+    same_elements &= (stats_1->sum == stats_2->sum);
     same_elements &=
             (memcmp(stats_1->counts, stats_2->counts, NR_COUNTS*sizeof(counts[0][0])) == 0);
     if (!same_elements) {
         printf("[" ANSI_COLOR_RED "ERROR" ANSI_COLOR_RESET "] Elements have changed.\n");
-        printf("\nSums: %lu ↔ %lu\nCounts: ", stats_1->sum, stats_2->sum);
+        printf("\nSums: %lu ↔ %lu\nFingerprints: %lu ↔ %lu\nCounts: ",
+                stats_1->sum, stats_2->sum, stats_1->fingerprint, stats_2->fingerprint);
         for (size_t c = 0; c < NR_COUNTS; c++) {
-            printf("%d: %zu ↔ %zu   ", c, stats_1->counts[c], stats_2->counts[c]);
+            printf("%zu: %zu ↔ %zu   ", c, stats_1->counts[c], stats_2->counts[c]);
         }
         printf("\n");
     }
@@ -186,6 +203,9 @@ bool compare_stats(array_stats const * const stats_1, array_stats const * const
     if (print_on_success)
         printf("[" ANSI_COLOR_GREEN "OK" ANSI_COLOR_RESET "] Elements are correctly sorted.\n");
     return EXIT_SUCCESS;
-}
-
+#else  // CHECK_SANITY
+    // Release builds do not print so as to keep the MRAM free. The caller aborts on a failure.
+    (void)print_on_success;
+    return (stats_1->fingerprint == stats_2->fingerprint) ? EXIT_SUCCESS : EXIT_FAILURE;
 #endif  // CHECK_SANITY
+}
@@ -2,7 +2,8 @@
  * @file
  * @brief Checking the sanity of generated and sorted numbers.
  * 
- * The use of some of these functions is intented for development purposes only.
+ * The fingerprint of the elements is always checked.
+ * The sum, the value counts, and the order are only checked with `CHECK_SANITY`.
 **/
 
 #ifndef _CHECKERS_H_
@@ -44,19 +45,19 @@ void print_single_line(T *array, size_t length);
 **/
 typedef struct array_stats
 {
-    /// @brief The sum of all elements in some array.
+    /// @brief The sum of the hashes of all elements in some array.
+    /// Unlike the sum and the counts, it changes with almost any change of the multiset of elements.
+    uint64_t fingerprint;
+    /// @brief The sum of all elements in some array. Only set with `CHECK_SANITY`.
     uint64_t sum;
-    /// @brief The counts of the values in the range `[0, 7]`.
+    /// @brief The counts of the values in the range `[0, 7]`. Only set with `CHECK_SANITY`.
     size_t counts[8];
-    /// @brief Whether the array is sorted.
+    /// @brief Whether the array is sorted. Only set with `CHECK_SANITY`.
     bool unsorted;
 } array_stats;
 
-#if (!CHECK_SANITY)
-    static inline
-#endif  // !CHECK_SANITY
 /**
- * @brief Calcucates the sum and gets the value counts of an MRAM array.
+ * @brief Calcucates the sum and the fingerprint and gets the value counts of an MRAM array.
  * 
  * @param array The MRAM array to check.
  * @param cache A cache in WRAM.
@@ -67,17 +68,10 @@ typedef struct array_stats
  * The value for `unsorted` is undefined.
 **/
 void get_stats_unsorted(T __mram_ptr const *array, T *cache, mram_range range,
-        bool dummy, array_stats *result)
-#if (!CHECK_SANITY)
-    { (void)array, (void)cache, (void)range, (void)dummy, (void)result; }
-#endif  // !CHECK_SANITY
-;
+        bool dummy, array_stats *result);
 
-#if (!CHECK_SANITY)
-    static inline
-#endif  // !CHECK_SANITY
 /**
- * @brief Calulcates the sum and gets the value counts of an MRAM array.
+ * @brief Calulcates the sum and the fingerprint and gets the value counts of an MRAM array.
  * Also checks whether the array is sorted.
  * 
  * @param array The MRAM array to check.
@@ -85,54 +79,36 @@ void get_stats_unsorted(T __mram_ptr const *array, T *cache, mram_range range,
  * @param range The range of indices for the calling tasklet to check.
  * @param dummy Whether a dummy variable was set.
  * If present, it is excluded from the statistics.
+ * @param single_part Whether the ranges of all tasklets form a single sorted array,
+ * so that the order is also checked across their borders.
+ * Otherwise, each range is checked on its own.
  * @param result The struct where the results are stored.
 **/
 void get_stats_sorted(T __mram_ptr const *array, T *cache, mram_range range,
-        bool dummy, array_stats *result)
-#if (!CHECK_SANITY)
-    { (void)array, (void)cache, (void)range, (void)dummy, (void)result; }
-#endif  // !CHECK_SANITY
-;
+        bool dummy, bool single_part, array_stats *result);
 
-#if (!CHECK_SANITY)
-    static inline
-#endif  // !CHECK_SANITY
 /**
- * @brief Calcucates the sum and gets the value counts of a WRAM array.
+ * @brief Calcucates the sum and the fingerprint and gets the value counts of a WRAM array.
  * 
  * @param array The WRAM array to check.
  * @param length The number of elements in the array.
  * @param result The struct where the results are stored.
  * The value for `unsorted` is undefined.
 **/
-void get_stats_unsorted_wram(T const array[], size_t length, array_stats *result)
-#if (!CHECK_SANITY)
-    { (void)array, (void)length, (void)result; }
-#endif  // !CHECK_SANITY
-;
+void get_stats_unsorted_wram(T const array[], size_t length, array_stats *result);
 
-#if (!CHECK_SANITY)
-    static inline
-#endif  // !CHECK_SANITY
 /**
- * @brief Calulcates the sum and gets the value counts of a WRAM array.
+ * @brief Calulcates the sum and the fingerprint and gets the value counts of a WRAM array.
  * Also checks whether the array is sorted.
  * 
  * @param array The WRAM array to check.
  * @param length The number of elements in the array.
  * @param result The struct where the results are stored.
 **/
-void get_stats_sorted_wram(T const array[], size_t length, array_stats *result)
-#if (!CHECK_SANITY)
-    { (void)array, (void)length, (void)result; }
-#endif  // !CHECK_SANITY
-;
+void get_stats_sorted_wram(T const array[], size_t length, array_stats *result);
 
-#if (!CHECK_SANITY)
-    static inline
-#endif  // !CHECK_SANITY
 /**
- * @brief Compares two given stats and prints appropriate messages.
+ * @brief Compares two given stats and, with `CHECK_SANITY`, prints appropriate messages.
  * 
  * @param stats_unsorted The statistics of the unsorted array.
  * @param stats_sorted The statistics of the sorted array.
@@ -141,10 +117,6 @@ void get_stats_sorted_wram(T const array[], size_t length, array_stats *result)
  * @return `EXIT_FAILURE` if a problem was detected, else `EXIT_SUCCESS`.
 **/
 bool compare_stats(array_stats const *stats_unsorted, array_stats const *stats_sorted,
-        bool print_on_success)
-#if (!CHECK_SANITY)
-    { (void)stats_unsorted, (void)stats_sorted, (void)print_on_success; return EXIT_SUCCESS; }
-#endif  // !CHECK_SANITY
-;
+        bool print_on_success);
 
 #endif  // _CHECKERS_H_
@@ -216,6 +216,43 @@ for (size_t k = 0; k < UNROLL_FACTOR; k++) {            \
     }                                                   \
 }
 
+#ifdef UINT32
+
+/**
+ * @brief Merges the `UNROLL_FACTOR` least items in the current pair of runs
+ * without any bounds checks. The items are written to the cache in pairs through 64-bit stores,
+ * so `i` must be even.
+**/
+#define UNROLLED_MERGE_UNCHECKED()                              \
+_Pragma("unroll")                                               \
+for (size_t k = 0; k < UNROLL_FACTOR; k += 2) {                 \
+    T pair[2];                                                  \
+    _Pragma("unroll")                                           \
+    for (size_t l = 0; l < 2; l++) {                            \
+        if (val[0] <= val[1]) {                                 \
+            pair[l] = val[0];                                   \
+            SR_GET(ptr[0], &sr[me()][0], mram[0], wram[0]);     \
+            val[0] = *ptr[0];                                   \
+        } else {                                                \
+            pair[l] = val[1];                                   \
+            SR_GET(ptr[1], &sr[me()][1], mram[1], wram[1]);     \
+            val[1] = *ptr[1];                                   \
+        }                                                       \
+    }                                                           \
+    store_pair(&cache[i + k], pair[0], pair[1]);                \
+}                                                               \
+i += UNROLL_FACTOR
+
+#else  // UINT32
+
+/**
+ * @brief Merges the `UNROLL_FACTOR` least items in the current pair of runs
+ * without any bounds checks.
+**/
+#define UNROLLED_MERGE_UNCHECKED() UNROLLED_MERGE({}, {})
+
+#endif  // UINT32
+
 /**
  * @brief Merges the `MAX_FILL_LENGTH` least items in the current pair of runs and
  * writes them to the MRAM.
@@ -234,6 +271,18 @@ mram_write(cache, out, MAX_FILL_SIZE);           \
 i = 0;                                           \
 out += MAX_FILL_LENGTH
 
+/**
+ * @brief Merges the `UNROLL_FACTOR` least items in the current pair of runs without any
+ * bounds checks and writes the cache to the MRAM once full.
+ * Since `i` is only ever increased by `UNROLL_FACTOR` or reset to zero, it remains even.
+**/
+#define MERGE_UNCHECKED_WITH_CACHE_FLUSH() \
+UNROLLED_MERGE_UNCHECKED();                \
+if (i < MAX_FILL_LENGTH) continue;         \
+mram_write(cache, out, MAX_FILL_SIZE);     \
+i = 0;                                     \
+out += MAX_FILL_LENGTH
+
 /**
  * @brief Merges two MRAM runs.
  * 
@@ -253,19 +302,31 @@ void merge_mram(T *ptr[2], T __mram_ptr * const ends[2], T __mram_ptr *out,
     if ((uintptr_t)out & DMA_OFF_MASK) {
         if (val[0] <= val[1]) {
             atomic_write(out++, val[0]);
+            if (sr_tell(ptr[0], &sr[me()][0], mram[0]) >= ends[0]) {  // A run of one item …
+                flush_run(sr_tell(ptr[1], &sr[me()][1], mram[1]), ends[1], out);
+                return;  // … is depleted already, and the merge loops must not read past it.
+            }
             SR_GET(ptr[0], &sr[me()][0], mram[0], wram[0]);
             val[0] = *ptr[0];
         } else {
             atomic_write(out++, val[1]);
+            if (sr_tell(ptr[1], &sr[me()][1], mram[1]) >= ends[1]) {
+                flush_run(sr_tell(ptr[0], &sr[me()][0], mram[0]), ends[0], out);
+                return;
+            }
             SR_GET(ptr[1], &sr[me()][1], mram[1], wram[1]);
             val[1] = *ptr[1];
         }
     }
 #endif
     if (*ends[0] <= *ends[1]) {
-        T __mram_ptr * const early_end = ends[0] - UNROLL_FACTOR + 1;
-        while ((intptr_t)sr_tell(ptr[0], &sr[me()][0], mram[0]) < (intptr_t)early_end) {
-            MERGE_WITH_CACHE_FLUSH({}, {});
+        // Each unrolled merge takes at most `UNROLL_FACTOR` items from the run ending first,
+        // so this many merges in a row cannot take its tail and need no checks in between.
+        size_t batches;
+        while ((batches = sr_items_ahead(ptr[0], &sr[me()][0], mram[0], ends[0]) / UNROLL_FACTOR)) {
+            do {
+                MERGE_UNCHECKED_WITH_CACHE_FLUSH();
+            } while (--batches);
         }
         while (true) {
             MERGE_WITH_CACHE_FLUSH(
@@ -283,9 +344,13 @@ void merge_mram(T *ptr[2], T __mram_ptr * const ends[2], T __mram_ptr *out,
             );
         }
     } else {
-        T __mram_ptr * const early_end = ends[1] - UNROLL_FACTOR + 1;
-        while ((intptr_t)sr_tell(ptr[1], &sr[me()][1], mram[1]) < (intptr_t)early_end) {
-            MERGE_WITH_CACHE_FLUSH({}, {});
+        // Each unrolled merge takes at most `UNROLL_FACTOR` items from the run ending first,
+        // so this many merges in a row cannot take its tail and need no checks in between.
+        size_t batches;
+        while ((batches = sr_items_ahead(ptr[1], &sr[me()][1], mram[1], ends[1]) / UNROLL_FACTOR)) {
+            do {
+                MERGE_UNCHECKED_WITH_CACHE_FLUSH();
+            } while (--batches);
         }
         while (true) {
             MERGE_WITH_CACHE_FLUSH(
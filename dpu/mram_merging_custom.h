@@ -0,0 +1,248 @@
+/**
+ * @file
+ * @brief Merging two given MRAM runs using custom readers.
+ *
+ * Offers the flag `MRAM_MERGE` to switch between full-space and half-space merging
+ * of DMA-aligned runs, as in `mram_merging_aligned.h`,
+ * and a third mode for runs and outputs anywhere, which relies on `mram_merging.h`.
+ * The proper output location must still be provided manually, of course.
+**/
+
+#ifndef _MRAM_MERGING_CUSTOM_H_
+#define _MRAM_MERGING_CUSTOM_H_
+
+#include <assert.h>
+#include <stdbool.h>
+
+#include <defs.h>
+
+#include "buffers.h"
+#include "common.h"
+#include "reader_custom.h"
+
+#define FULL_SPACE (1)
+#define HALF_SPACE (2)
+#define UNALIGNED_FULL_SPACE (3)
+#if (MRAM_MERGE == FULL_SPACE)
+
+#define FLUSH_FIRST_DEPLETED() flush_cache_and_run_custom(&readers[1], out, i)
+
+#define FLUSH_SECOND_DEPLETED() flush_cache_and_run_custom(&readers[0], out, i)
+
+#elif (MRAM_MERGE == HALF_SPACE)
+
+#define FLUSH_FIRST_DEPLETED() flush_cache_custom(&readers[1], out, i)
+
+#define FLUSH_SECOND_DEPLETED() flush_cache_and_run_custom(&readers[0], out, i)
+
+#elif (MRAM_MERGE == UNALIGNED_FULL_SPACE)
+
+#include "mram_merging.h"
+
+#define FLUSH_FIRST_DEPLETED()                                                      \
+flush_cache_and_run(readers[1].ptr, get_reader_mram_address(&readers[1]), readers[1].to, out, i)
+
+#define FLUSH_SECOND_DEPLETED()                                                     \
+flush_cache_and_run(readers[0].ptr, get_reader_mram_address(&readers[0]), readers[0].to, out, i)
+
+#endif  // MRAM_MERGE == UNALIGNED_FULL_SPACE
+
+/// @brief How many items are merged in an unrolled fashion.
+#define UNROLL_FACTOR (8)
+/// @brief How many items the cache holds before they are written to the MRAM.
+#define MAX_FILL_LENGTH (MAX_TRANSFER_LENGTH_CACHE / UNROLL_FACTOR * UNROLL_FACTOR)
+/// @brief How many bytes the items the cache holds before they are written to the MRAM have.
+#define MAX_FILL_SIZE (MAX_FILL_LENGTH << DIV)
+
+static_assert(
+    UNROLL_FACTOR * sizeof(T) == DMA_ALIGNED(UNROLL_FACTOR * sizeof(T)),
+    "`UNROLL_FACTOR * sizeof(T)` must be DMA-aligned "
+    "as, otherwise, the quick cache flush after the first tier is not possible."
+);
+
+extern triple_buffers buffers[NR_TASKLETS];
+
+/**
+ * @brief Write whatever is still in the cache to the MRAM.
+ * If the given run is not depleted, copy its remainder to the output.
+ *
+ * @param reader A reader on the run.
+ * @param out Whither to flush.
+ * @param i The number of items currently in the cache.
+**/
+static inline void flush_cache_and_run_custom(struct reader * const reader, T __mram_ptr *out,
+        size_t i) {
+    T * const cache = buffers[me()].cache;
+    T __mram_ptr *from = get_reader_mram_address(reader);
+    /* Transfer cache to MRAM. */
+#ifdef UINT32
+    if (i & 1) {  // Is there need for alignment?
+        // This is easily possible since the non-depleted run must have at least one more item.
+        cache[i++] = get_reader_value(reader);
+        if (from == reader->to) {
+            mram_write(cache, out, i * sizeof(T));
+            return;
+        }
+        reader->ptr++;
+        from++;
+    }
+#endif
+    mram_write(cache, out, i * sizeof(T));
+    out += i;
+
+    size_t const rem_length = MIN(reader->last_item, reader->buffer_end) - reader->ptr + 1;
+    if (rem_length != 0) {
+        mram_write(reader->ptr, out, rem_length * sizeof(T));
+        from += rem_length;
+        out += rem_length;
+    }
+
+    /* Transfer from MRAM to MRAM. */
+    size_t rem_size = MAX_TRANSFER_SIZE_TRIPLE;
+    while (from <= reader->to) {
+        // Thanks to the dummy values, even for numbers smaller than `DMA_ALIGNMENT` bytes,
+        // there is no need to round the size up.
+        if (from + MAX_TRANSFER_LENGTH_TRIPLE > reader->to) {
+            rem_size = (size_t)reader->to - (size_t)from + sizeof(T);
+        }
+        mram_read(from, cache, rem_size);
+        mram_write(cache, out, rem_size);
+        from += MAX_TRANSFER_LENGTH_TRIPLE;  // Value may be wrong for the last transfer …
+        out += MAX_TRANSFER_LENGTH_TRIPLE;  // … after which it is not needed anymore, however.
+    };
+}
+
+/**
+ * @brief Write whatever is still in the cache to the MRAM.
+ *
+ * @param reader A reader on the run.
+ * @param out Whither to flush.
+ * @param i The number of items currently in the cache.
+**/
+static inline void flush_cache_custom(struct reader * const reader, T __mram_ptr * const out,
+        size_t i) {
+    T * const cache = buffers[me()].cache;
+    (void)reader;
+    /* Transfer cache to MRAM. */
+#ifdef UINT32
+    if (i & 1) {  // Is there need for alignment?
+        // This is easily possible since the non-depleted run must have at least one more item.
+        cache[i++] = get_reader_value(reader);
+    }
+#endif
+    mram_write(cache, out, i * sizeof(T));
+}
+
+/**
+ * @brief Merges the `MAX_FILL_LENGTH` least items in the current pair of runs.
+ * @internal If one of the runs does not contain sufficiently many items anymore,
+ * bounds checks on both runs occur with each itemal merge. The reason is that
+ * the unrolling everywhere makes the executable too big if the check is more fine-grained.
+ *
+ * @param flush_0 An if block checking whether the tail of the first run is reached
+ * and calling the appropriate flushing function. May be an empty block
+ * if it is known that the tail cannot be reached.
+ * @param flush_1  An if block checking whether the tail of the second run is reached
+ * and calling the appropriate flushing function. May be an empty block
+ * if it is known that the tail cannot be reached.
+**/
+#define UNROLLED_MERGE_CUSTOM(flush_0, flush_1)                                 \
+if (!is_early_end_reached(&readers[0]) && !is_early_end_reached(&readers[1])) { \
+    _Pragma("unroll")                                                           \
+    for (size_t k = 0; k < UNROLL_FACTOR; k++) {                                \
+        if (get_reader_value(&readers[0]) <= get_reader_value(&readers[1])) {   \
+            cache[i++] = get_reader_value(&readers[0]);                         \
+            flush_0;                                                            \
+            update_reader_partially(&readers[0]);                               \
+        } else {                                                                \
+            cache[i++] = get_reader_value(&readers[1]);                         \
+            flush_1;                                                            \
+            update_reader_partially(&readers[1]);                               \
+        }                                                                       \
+    }                                                                           \
+} else {                                                                        \
+    _Pragma("unroll")                                                           \
+    for (size_t k = 0; k < UNROLL_FACTOR; k++) {                                \
+        if (get_reader_value(&readers[0]) <= get_reader_value(&readers[1])) {   \
+            cache[i++] = get_reader_value(&readers[0]);                         \
+            flush_0;                                                            \
+            update_reader_fully(&readers[0]);                                   \
+        } else {                                                                \
+            cache[i++] = get_reader_value(&readers[1]);                         \
+            flush_1;                                                            \
+            update_reader_fully(&readers[1]);                                   \
+        }                                                                       \
+    }                                                                           \
+}
+
+/**
+ * @brief Merges the `MAX_FILL_LENGTH` least items in the current pair of runs and
+ * writes them to the MRAM.
+ *
+ * @param flush_0 An if block checking whether the tail of the first run is reached
+ * and calling the appropriate flushing function. May be an empty block
+ * if it is known that the tail cannot be reached.
+ * @param flush_1  An if block checking whether the tail of the second run is reached
+ * and calling the appropriate flushing function. May be an empty block
+ * if it is known that the tail cannot be reached.
+**/
+#define MERGE_CUSTOM_WITH_CACHE_FLUSH(flush_0, flush_1) \
+UNROLLED_MERGE_CUSTOM(flush_0, flush_1);                \
+if (i < MAX_FILL_LENGTH) continue;                      \
+mram_write(cache, out, MAX_FILL_SIZE);                  \
+i = 0;                                                  \
+out += MAX_FILL_LENGTH
+
+/**
+ * @brief Merges two MRAM runs. With `HALF_SPACE`, the first run is not flushed
+ * if the second run is depleted first.
+ *
+ * @param readers A pair of readers on the two non-empty runs.
+ * @param out Whither the merged runs are written.
+**/
+static inline void merge_mram_custom(struct reader readers[2], T __mram_ptr *out) {
+    T * const cache = buffers[me()].cache;
+    size_t i = 0;
+#if (MRAM_MERGE == UNALIGNED_FULL_SPACE) && defined(UINT32)
+    if ((uintptr_t)out & DMA_OFF_MASK) {  // A single item is written to align `out`.
+        struct reader * const lesser =
+                &readers[get_reader_value(&readers[1]) < get_reader_value(&readers[0])];
+        atomic_write(out++, get_reader_value(lesser));
+        if (is_current_item_the_last_one(lesser)) {  // A run of one item is depleted already.
+            struct reader * const other = &readers[lesser == &readers[0]];
+            flush_run(get_reader_mram_address(other), other->to, out);
+            return;
+        }
+        update_reader_fully(lesser);
+    }
+#endif
+    if (*readers[0].to <= *readers[1].to) {
+        while (items_left_in_reader(&readers[0]) > UNROLL_FACTOR) {
+            MERGE_CUSTOM_WITH_CACHE_FLUSH({}, {});
+        }
+        while (true) {
+            MERGE_CUSTOM_WITH_CACHE_FLUSH(
+                if (is_current_item_the_last_one(&readers[0])) {
+                    FLUSH_FIRST_DEPLETED();
+                    return;
+                },
+                {}
+            );
+        }
+    } else {
+        while (items_left_in_reader(&readers[1]) > UNROLL_FACTOR) {
+            MERGE_CUSTOM_WITH_CACHE_FLUSH({}, {});
+        }
+        while (true) {
+            MERGE_CUSTOM_WITH_CACHE_FLUSH(
+                {},
+                if (is_current_item_the_last_one(&readers[1])) {
+                    FLUSH_SECOND_DEPLETED();
+                    return;
+                }
+            );
+        }
+    }
+}
+
+#endif  // _MRAM_MERGING_CUSTOM_H_
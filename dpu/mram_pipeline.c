@@ -0,0 +1,310 @@
+#include <stddef.h>
+
+#include <defs.h>
+#include <mram.h>
+
+#include "mram_pipeline.h"
+#include "mram_sorts.h"
+#include "starting_runs.h"
+
+#define MRAM_MERGE FULL_SPACE
+#include "mram_merging_aligned.h"
+
+extern T __mram_ptr input[];
+extern T __mram_ptr output[];
+
+extern bool flipped[NR_TASKLETS];  // Whether `output` contains the latest sorted runs.
+
+static_assert(PIPE_SLOT_SIZE >= DMA_ALIGNMENT, "The pages of the pipeline are too small!");
+static_assert(!(PIPE_SLOTS & (PIPE_SLOTS - 1)), "`PIPE_SLOTS` must be a power of two!");
+
+/// @brief The shared states of the pairs of tasklets. A pair is indexed by its merging tasklet.
+static struct pipeline pipelines[(NR_TASKLETS + 1) / 2];
+
+/// @brief Keeps the compiler from moving memory accesses across the update of a shared counter.
+#define PIPE_FENCE() __asm__ volatile("" ::: "memory")
+
+/**
+ * @brief Returns the WRAM address of a page of a ring buffer.
+ * The rings lie in the triple buffer of the merging tasklet.
+ *
+ * @param merger The merging tasklet.
+ * @param ring The ring, with 0 and 1 being the runs and 2 being the output.
+ * @param slot The number of the page, which is taken modulo `PIPE_SLOTS`.
+ *
+ * @return The first item of the page.
+**/
+static inline T *get_slot(sysname_t const merger, size_t const ring, uint32_t const slot) {
+    size_t const index = ring * PIPE_SLOTS + (slot & (PIPE_SLOTS - 1));
+    return buffers[merger].cache + index * PIPE_SLOT_LENGTH;
+}
+
+/**
+ * @brief Serves the merges of the partner until it quits.
+ * Reads pages of the runs as long as their rings have space,
+ * writes published output pages, and copies the remainder of a run at the end of each merge.
+ *
+ * @param pipe The shared state of the pair.
+ * @param merger The merging tasklet.
+**/
+static void serve_merges(struct pipeline * const pipe, sysname_t const merger) {
+    while (true) {
+        while (pipe->jobs_done == pipe->jobs_posted && !pipe->quit)
+            SPIN_WAIT();
+        if (pipe->jobs_done == pipe->jobs_posted)
+            return;
+        PIPE_FENCE();
+        T __mram_ptr *next[2] = { pipe->run_starts[0], pipe->run_starts[1] };
+        uint32_t filled[2] = { 0, 0 }, written = 0;
+        while (true) {
+            bool const finishing = pipe->finishing;
+            PIPE_FENCE();
+            if (written != pipe->published) {  // Writes first, for they may stall the merger.
+                PIPE_FENCE();
+                mram_write(get_slot(merger, 2, written), &pipe->out[written * PIPE_SLOT_LENGTH],
+                        pipe->out_sizes[written & (PIPE_SLOTS - 1)]);
+                PIPE_FENCE();
+                pipe->written = ++written;
+                continue;
+            }
+            if (finishing)
+                break;
+            bool idle = true;
+            for (size_t r = 0; r < 2; r++) {
+                if (filled[r] - pipe->freed[r] == PIPE_SLOTS || next[r] > pipe->run_ends[r])
+                    continue;
+                idle = false;
+                size_t const size = (next[r] + PIPE_SLOT_LENGTH > pipe->run_ends[r]) ?
+                        (size_t)pipe->run_ends[r] - (size_t)next[r] + sizeof(T) :
+                        PIPE_SLOT_SIZE;
+                mram_read(next[r], get_slot(merger, r, filled[r]), size);
+                next[r] += PIPE_SLOT_LENGTH;
+                PIPE_FENCE();
+                pipe->filled[r] = ++filled[r];
+            }
+            if (idle)
+                SPIN_WAIT();
+        }
+        flush_run_aligned(pipe->remainder_from, pipe->remainder_to, pipe->remainder_out);
+        PIPE_FENCE();
+        pipe->jobs_done++;
+    }
+}
+
+/**
+ * @brief Moves on to the next page of a run once the current one is read,
+ * releasing the current page to the helper.
+ *
+ * @param pipe The shared state of the pair.
+ * @param r The run.
+ * @param pages How many pages of the run have been released so far. Is incremented.
+ * @param pages_total How many pages the run has.
+ * @param length The number of items of the run.
+ * @param ptr Set to the first item of the next page.
+ * @param last Set to the last item of the next page.
+ *
+ * @return Whether the run still has pages.
+**/
+static inline bool next_page(struct pipeline * const pipe, size_t const r, uint32_t * const pages,
+        uint32_t const pages_total, size_t const length, T ** const ptr, T ** const last) {
+    PIPE_FENCE();
+    pipe->freed[r] = ++*pages;
+    if (*pages == pages_total)
+        return false;
+    while (pipe->filled[r] == *pages)
+        SPIN_WAIT();
+    PIPE_FENCE();
+    *ptr = get_slot(me(), r, *pages);
+    size_t const page_length = (*pages == pages_total - 1) ?
+            length - *pages * PIPE_SLOT_LENGTH :
+            PIPE_SLOT_LENGTH;
+    *last = *ptr + page_length - 1;
+    return true;
+}
+
+/**
+ * @brief Merges two neighbouring MRAM runs with the help of the partner.
+ * Only the pages in the rings are accessed; all DMAs are done by the helper.
+ *
+ * @param pipe The shared state of the pair.
+ * @param starts The first items of the two runs.
+ * @param ends The last items of the two runs.
+ * @param out Whither the merged runs are written.
+**/
+static void merge_pipelined(struct pipeline * const pipe, T __mram_ptr * const starts[2],
+        T __mram_ptr * const ends[2], T __mram_ptr * const out) {
+    /* Post the merge. */
+    size_t const lengths[2] = { ends[0] - starts[0] + 1, ends[1] - starts[1] + 1 };
+    uint32_t const pages_total[2] = {
+        DIV_CEIL(lengths[0], PIPE_SLOT_LENGTH),
+        DIV_CEIL(lengths[1], PIPE_SLOT_LENGTH),
+    };
+    for (size_t r = 0; r < 2; r++) {
+        pipe->run_starts[r] = starts[r];
+        pipe->run_ends[r] = ends[r];
+        pipe->filled[r] = 0;
+        pipe->freed[r] = 0;
+    }
+    pipe->out = out;
+    pipe->published = 0;
+    pipe->written = 0;
+    pipe->finishing = false;
+    size_t const first_run = (*ends[0] <= *ends[1]) ? 0 : 1;  // Read before the helper starts.
+    PIPE_FENCE();
+    pipe->jobs_posted++;
+
+    /* Wait for the first pages. */
+    uint32_t pages[2] = { 0, 0 }, published = 0;
+    T *ptr[2], *last[2], val[2];
+    for (size_t r = 0; r < 2; r++) {
+        while (pipe->filled[r] == 0)
+            SPIN_WAIT();
+        PIPE_FENCE();
+        ptr[r] = get_slot(me(), r, 0);
+        last[r] = ptr[r] + ((lengths[r] < PIPE_SLOT_LENGTH) ? lengths[r] : PIPE_SLOT_LENGTH) - 1;
+        val[r] = *ptr[r];
+    }
+
+    /* Merge until the run whose last item is lesser is depleted. */
+    // Only said run can become depleted since the last item of the other one is merged last.
+    T *o = get_slot(me(), 2, 0), *o_end = o + PIPE_SLOT_LENGTH;
+    while (true) {
+        if (val[0] <= val[1]) {
+            *o++ = val[0];
+            if (ptr[0]++ == last[0] && !next_page(pipe, 0, &pages[0], pages_total[0], lengths[0],
+                    &ptr[0], &last[0]))
+                break;
+            val[0] = *ptr[0];
+        } else {
+            *o++ = val[1];
+            if (ptr[1]++ == last[1] && !next_page(pipe, 1, &pages[1], pages_total[1], lengths[1],
+                    &ptr[1], &last[1]))
+                break;
+            val[1] = *ptr[1];
+        }
+        if (o == o_end) {  // Hand the full page over and wait for a free one.
+            pipe->out_sizes[published & (PIPE_SLOTS - 1)] = PIPE_SLOT_SIZE;
+            PIPE_FENCE();
+            pipe->published = ++published;
+            while (published - pipe->written == PIPE_SLOTS)
+                SPIN_WAIT();
+            PIPE_FENCE();
+            o = get_slot(me(), 2, published);
+            o_end = o + PIPE_SLOT_LENGTH;
+        }
+    }
+
+    /* Hand over the last page and the remainder of the other run. */
+    size_t const other = 1 - first_run;
+    T __mram_ptr *from = starts[other] + pages[other] * PIPE_SLOT_LENGTH
+            + (ptr[other] - get_slot(me(), other, pages[other]));
+    size_t in_page = o - get_slot(me(), 2, published);
+#ifdef UINT32
+    if (in_page & 1) {  // Is there need for alignment?
+        // This is easily possible since the non-depleted run must have at least one more item.
+        *o = val[other];
+        in_page++;
+        from++;
+    }
+#endif
+    pipe->remainder_from = from;
+    pipe->remainder_to = ends[other];
+    pipe->remainder_out = out + published * PIPE_SLOT_LENGTH + in_page;
+    if (in_page) {
+        pipe->out_sizes[published & (PIPE_SLOTS - 1)] = in_page << DIV;
+        PIPE_FENCE();
+        pipe->published = ++published;
+    }
+    PIPE_FENCE();
+    pipe->finishing = true;
+    while (pipe->jobs_done != pipe->jobs_posted)
+        SPIN_WAIT();
+    PIPE_FENCE();
+}
+
+/**
+ * @brief Sorts a part whose starting runs are formed by merging pairs of runs with the helper.
+ *
+ * @param pipe The shared state of the pair.
+ * @param start The first item of the part.
+ * @param end The last item of the part.
+ * @param owner The tasklet to whom the part belongs, whose entry of `flipped` is updated.
+ * @param starting_run_length The length of the starting runs of the part.
+**/
+static void merge_part_pipelined(struct pipeline * const pipe, T __mram_ptr * const start,
+        T __mram_ptr * const end, sysname_t const owner, size_t const starting_run_length) {
+    T __mram_ptr *in, *until, *out;  // Runs from `in` to `until` are merged and stored at `out`.
+    bool flip = false;  // Used to determine the initial positions of `in` and `out`.
+    if ((intptr_t)end < (intptr_t)start) {  // An empty part has no runs to hand to the helper.
+        flipped[owner] = flip;
+        return;
+    }
+    size_t const n = end - start + 1;
+    for (size_t run_length = starting_run_length; run_length < n; run_length *= 2) {
+        // Set the positions to read from and write to.
+        if ((flip = !flip)) {
+            in = start;
+            until = end;
+            out = &output[start - input] + n;
+        } else {
+            in = &output[start - input];
+            until = &output[start - input] + n - 1;
+            out = end + 1;
+        }
+        // Merge pairs of neighboured runs.
+        T __mram_ptr *run_1_end = until - run_length;
+        for (; (intptr_t)run_1_end >= (intptr_t)in; run_1_end -= 2*run_length) {
+            T __mram_ptr *run_1_start;
+            if ((intptr_t)(run_1_end + 1 - run_length) >= (intptr_t)in) {
+                run_1_start = run_1_end + 1 - run_length;
+                out -= 2*run_length;
+            } else {
+                run_1_start = in;
+                out -= run_length + (run_1_end - run_1_start + 1);
+            }
+            T __mram_ptr * const starts[2] = { run_1_start, run_1_end + 1 };
+            T __mram_ptr * const ends[2] = { run_1_end, run_1_end + run_length };
+            merge_pipelined(pipe, starts, ends, out);
+        }
+        // Flush single run at the beginning straight away
+        if ((intptr_t)(run_1_end + run_length) >= (intptr_t)in) {
+            out = (flip) ? &output[start - input] : start;
+            copy_run(in, run_1_end + run_length, out);
+        }
+    }
+    flipped[owner] = flip;
+}
+
+void merge_sort_mram_pipelined(T __mram_ptr * const start, T __mram_ptr * const end) {
+    sysname_t const merger = me() & ~1;
+    if (merger + 1 >= NR_TASKLETS) {  // unpaired tasklet
+        merge_sort_mram(start, end);
+        return;
+    }
+    struct pipeline * const pipe = &pipelines[merger / 2];
+
+    /* Starting runs. */
+    size_t const starting_run_length = form_starting_runs_shared(start, end, start);
+    if (me() != merger) {
+        pipe->helper_start = start;
+        pipe->helper_end = end;
+        pipe->helper_run_length = starting_run_length;
+        PIPE_FENCE();
+        pipe->helper_ready = true;
+        serve_merges(pipe, merger);
+        pipe->helper_ready = false;
+        return;
+    }
+
+    /* Merging, first the own part, then the one of the helper. */
+    merge_part_pipelined(pipe, start, end, me(), starting_run_length);
+    while (!pipe->helper_ready)
+        SPIN_WAIT();
+    PIPE_FENCE();
+    merge_part_pipelined(pipe, pipe->helper_start, pipe->helper_end, me() + 1,
+            pipe->helper_run_length);
+    pipe->quit = true;
+    while (pipe->helper_ready)  // Both must leave before the next call may reset `quit`.
+        SPIN_WAIT();
+    pipe->quit = false;
+}
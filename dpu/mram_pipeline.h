@@ -0,0 +1,85 @@
+/**
+ * @file
+ * @brief Sequential sorting of MRAM data through a full-space MergeSort
+ * whose DMAs are offloaded to a helper tasklet.
+ *
+ * Tasklets are paired up: the even tasklet merges, the odd one is its helper.
+ * The helper prefetches the pages of the runs to merge and writes out filled output pages,
+ * while the merging tasklet only ever touches WRAM.
+ * Both exchange pages through single-producer/single-consumer ring buffers,
+ * so that merging and DMAs overlap without any locks.
+ * The merging tasklet sorts its own part first and the part of its helper afterwards.
+**/
+
+#ifndef _MRAM_PIPELINE_H_
+#define _MRAM_PIPELINE_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <mram.h>
+
+#include "buffers.h"
+#include "common.h"
+
+/// @brief How many pages each ring buffer holds. Must be a power of two.
+#define PIPE_SLOTS (4)
+/// @brief The size of a page in bytes. Three rings of `PIPE_SLOTS` pages fill a triple buffer.
+#define PIPE_SLOT_SIZE ((((TRIPLE_BUFFER_SIZE / (3 * PIPE_SLOTS)) > 2048) ? 2048 : \
+        (TRIPLE_BUFFER_SIZE / (3 * PIPE_SLOTS))) & ~DMA_OFF_MASK)
+/// @brief The number of items in a page.
+#define PIPE_SLOT_LENGTH (PIPE_SLOT_SIZE >> DIV)
+
+/**
+ * @brief The state shared by a merging tasklet and its helper.
+ * Each counter is only ever written by one of both tasklets.
+**/
+struct pipeline {
+    /// @brief The first items of the two runs to merge.
+    T __mram_ptr *run_starts[2];
+    /// @brief The last items of the two runs to merge.
+    T __mram_ptr *run_ends[2];
+    /// @brief Whither the merged runs are written.
+    T __mram_ptr *out;
+    /// @brief The remainder of the non-depleted run which the helper copies at the end of a merge.
+    T __mram_ptr *remainder_from, *remainder_to, *remainder_out;
+    /// @brief The number of bytes in each output page when it is published.
+    uint32_t out_sizes[PIPE_SLOTS];
+    /// @brief How many pages of each run the helper has read (written by the helper).
+    uint32_t volatile filled[2];
+    /// @brief How many pages of each run the merger has released (written by the merger).
+    uint32_t volatile freed[2];
+    /// @brief How many output pages the merger has filled (written by the merger).
+    uint32_t volatile published;
+    /// @brief How many output pages the helper has written to the MRAM (written by the helper).
+    uint32_t volatile written;
+    /// @brief How many merges the merger has posted (written by the merger).
+    uint32_t volatile jobs_posted;
+    /// @brief How many merges the helper has completed (written by the helper).
+    uint32_t volatile jobs_done;
+    /// @brief Whether the merger has published its last page of the current merge.
+    bool volatile finishing;
+    /// @brief Whether the merger has sorted both parts and the helper may return.
+    bool volatile quit;
+    /// @brief Whether the helper has formed the starting runs of its part.
+    bool volatile helper_ready;
+    /// @brief The first item of the part of the helper.
+    T __mram_ptr *helper_start;
+    /// @brief The last item of the part of the helper.
+    T __mram_ptr *helper_end;
+    /// @brief The length of the starting runs in the part of the helper.
+    size_t helper_run_length;
+};
+
+/**
+ * @brief A sequential MRAM implementation of full-space MergeSort with a helper tasklet for DMAs.
+ * Must be called by all tasklets at once. Each pair of tasklets sorts both of their parts.
+ * With an odd number of tasklets, the last one sorts its part on its own.
+ *
+ * @param start The first item of the MRAM array to sort.
+ * @param end The last item of said array.
+**/
+void merge_sort_mram_pipelined(T __mram_ptr * const start, T __mram_ptr * const end);
+
+#endif  // _MRAM_PIPELINE_H_
@@ -6,29 +6,53 @@
 
 #define MRAM_MERGE FULL_SPACE
 #include "mram_merging_aligned.h"
+#include "mram_merging_custom.h"
 
+extern T __mram_ptr input[];
 extern T __mram_ptr output[];
 
 extern bool flipped[NR_TASKLETS];  // Whether `output` contains the latest sorted runs.
 
+size_t merge_passes(size_t const length, size_t const run_length) {
+    size_t passes = 0;
+    for (size_t merged = run_length; merged < length; merged *= 2)
+        passes++;
+    return passes;
+}
+
 void merge_sort_mram(T __mram_ptr * const start, T __mram_ptr * const end) {
+    size_t const passes = merge_passes(end - start + 1, shared_run_length(me()));
+    merge_sort_mram_into(start, end, passes & 1);
+}
+
+void merge_sort_mram_into(T __mram_ptr * const start, T __mram_ptr * const end,
+        bool const into_output) {
     /* Starting runs. */
-    form_starting_runs(start, end);
+    size_t const n = end - start + 1;
+    // If the merge passes alone would leave the part in the wrong array,
+    // the starting runs are formed in `output` already.
+    bool flip = into_output != (merge_passes(n, shared_run_length(me())) & 1);
+    T __mram_ptr * const runs = (flip) ? &output[start - input] : start;
+    size_t const starting_run_length = form_starting_runs_shared(start, end, runs);
 
     /* Merging. */
+#if CUSTOM_READER
+    struct reader readers[2];
+    setup_reader(&readers[0], buffers[me()].seq_1, UNROLL_FACTOR);
+    setup_reader(&readers[1], buffers[me()].seq_2, UNROLL_FACTOR);
+#else
     seqreader_buffer_t const wram[2] = { buffers[me()].seq_1, buffers[me()].seq_2 };
+#endif
     T __mram_ptr *in, *until, *out;  // Runs from `in` to `until` are merged and stored at `out`.
-    bool flip = flipped[me()];  // Used to determine the initial positions of `in`, `out`, and `until`.
-    size_t const n = end - start + 1;
-    for (size_t run_length = STARTING_RUN_LENGTH; run_length < n; run_length *= 2) {
+    for (size_t run_length = starting_run_length; run_length < n; run_length *= 2) {
         // Set the positions to read from and write to.
         if ((flip = !flip)) {
             in = start;
             until = end;
-            out = (T __mram_ptr *)((uintptr_t)start + (uintptr_t)output) + n;
+            out = &output[start - input] + n;
         } else {
-            in = (T __mram_ptr *)((uintptr_t)start + (uintptr_t)output);
-            until = (T __mram_ptr *)((uintptr_t)start + (uintptr_t)output) + n - 1;
+            in = &output[start - input];
+            until = &output[start - input] + n - 1;
             out = end + 1;
         }
         // Merge pairs of neighboured runs.
@@ -42,16 +66,22 @@ void merge_sort_mram(T __mram_ptr * const start, T __mram_ptr * const end) {
                 run_1_start = in;
                 out -= run_length + (run_1_end - run_1_start + 1);
             }
+#if CUSTOM_READER
+            reset_reader(&readers[0], run_1_start, run_1_end);
+            reset_reader(&readers[1], run_1_end + 1, run_1_end + run_length);
+            merge_mram_custom(readers, out);
+#else
             T __mram_ptr * const ends[2] = { run_1_end, run_1_end + run_length };
             T *ptr[2] = {
-                sr_init(buffers[me()].seq_1, run_1_start, &sr[me()][0]),
-                sr_init(buffers[me()].seq_2, run_1_end + 1, &sr[me()][1]),
+                sr_init(buffers[me()].seq_1, run_1_start, &sr[me()][0], ends[0]),
+                sr_init(buffers[me()].seq_2, run_1_end + 1, &sr[me()][1], ends[1]),
             };
             merge_mram_aligned(ptr, ends, out, wram);
+#endif
         }
         // Flush single run at the beginning straight away
         if ((intptr_t)(run_1_end + run_length) >= (intptr_t)in) {
-            out = (flip) ? (T __mram_ptr *)((uintptr_t)start + (uintptr_t)output) : start;
+            out = (flip) ? &output[start - input] : start;
             copy_run(in, run_1_end + run_length, out);
         }
     }
@@ -6,6 +6,7 @@
 #define _MRAM_SORTS_H_
 
 #include <stdbool.h>
+#include <stddef.h>
 
 #include <mram.h>
 
@@ -15,10 +16,36 @@ extern bool flipped[NR_TASKLETS];  // Whether `output` contains the latest sorte
 
 /**
  * @brief A sequential MRAM implementation of full-space MergeSort.
+ * @note Must be called by all tasklets at once since they form the starting runs together.
  * 
  * @param start The first item of the MRAM array to sort.
  * @param end The last item of said array.
 **/
 void merge_sort_mram(T __mram_ptr * const start, T __mram_ptr * const end);
 
+/**
+ * @brief Returns the number of merge passes which `merge_sort_mram` needs for a part.
+ * If it is odd, the sorted part ends up in `output`.
+ * 
+ * @param length The number of items in the part.
+ * @param run_length The length of the starting runs in the part.
+ * 
+ * @return The number of merge passes.
+**/
+size_t merge_passes(size_t length, size_t run_length);
+
+/**
+ * @brief A sequential MRAM implementation of full-space MergeSort
+ * whose sorted array ends up in the given array.
+ * If this takes an additional flip, the starting runs are written straight to `output`,
+ * so no pass over the array is spent on it.
+ * @note Must be called by all tasklets at once since they form the starting runs together.
+ * 
+ * @param start The first item of the MRAM array to sort.
+ * @param end The last item of said array.
+ * @param into_output Whether the sorted array must end up in `output` rather than `input`.
+**/
+void merge_sort_mram_into(T __mram_ptr * const start, T __mram_ptr * const end,
+        bool const into_output);
+
 #endif  // _MRAM_SORTS_H_
@@ -80,3 +80,104 @@ void generate_almost_sorted_distribution_wram(T * const start, T * const end, si
         swap(&start[i], &start[j]);
     }
 }
+
+/**
+ * @brief Returns the greatest common divisor of two numbers.
+**/
+static size_t gcd(size_t a, size_t b) {
+    while (b) {
+        size_t const r = a % b;
+        a = b;
+        b = r;
+    }
+    return a;
+}
+
+/**
+ * @brief Computes a single element of a distribution whose elements are independent of each other.
+ * 
+ * @param i The index of the element relative to the start of the range.
+ * @param n The length of the range.
+ * @param type The distribution to draw from.
+ * @param param The parameter of the distribution, with zero already replaced by its default.
+ * @param step Only used by `shuffledblocks`: a number coprime to the number of blocks.
+ * @param shift Only used by `shuffledblocks`: by how many blocks the order is rotated.
+ * 
+ * @return The element at index `i`.
+**/
+static T get_element(size_t const i, size_t const n, enum dist const type, T const param,
+        size_t const step, size_t const shift) {
+    switch (type) {
+    case sawtooth:
+        return i % param;
+    case organpipe:
+        return (i < n - 1 - i) ? i : n - 1 - i;
+    case sortedruns: {
+        size_t const run_length = DIV_CEIL(n, param);
+        return (i % run_length) * param + i / run_length;
+    }
+    case fewunique:
+        return rr(param, &input_rngs[me()]) * (T_MAX / param);
+    case shuffledblocks: {
+        size_t const blocks = DIV_CEIL(n, param);
+        uint64_t const block = ((uint64_t)(i / param) * step + shift) % blocks;
+        return block * param + i % param;
+    }
+    case medkiller: {
+        size_t const k = n / 2;
+        if (i >= 2 * k) return n;
+        return (i >= k) ? 2 * (i - k + 1) : ((i & 1) ? k + i : i + 1);
+    }
+    case mergekiller:
+        return (i / param) * param + rr(param, &input_rngs[me()]);
+    default:
+        return gen_xs(&input_rngs[me()]);
+    }
+}
+
+void generate_input_distribution_mram(T __mram_ptr *array, T * const cache,
+        mram_range const * const range, enum dist const type, T param) {
+    size_t const n = range->end - range->start;
+    size_t const root = (sqroot_on_dpu(n) >= 1) ? sqroot_on_dpu(n) : 1;
+    size_t step = 1, shift = 0;
+    switch (type) {
+    case sorted: generate_sorted_distribution_mram(array, cache, range); return;
+    case reverse: generate_reverse_sorted_distribution_mram(array, cache, range); return;
+    case zeroone: generate_uniform_distribution_mram(array, cache, range, 2); return;
+    case uniform: generate_uniform_distribution_mram(array, cache, range, param); return;
+    case zipf:
+    case normal: generate_uniform_distribution_mram(array, cache, range, 0); return;
+    case sawtooth:
+    case sortedruns: param = (param) ? : root; break;
+    case fewunique: param = (param) ? : 16; break;
+    case shuffledblocks: {
+        param = (param) ? : root;
+        size_t const blocks = DIV_CEIL(n, param);
+        for (step = (blocks * 5 / 8) | 1; gcd(step, blocks) != 1; step += 2);
+        shift = rr(blocks, &input_rngs[me()]);
+        break;
+    }
+    case mergekiller:
+        param = (param) ? :
+                ((DMA_ALIGNED(DIV_CEIL(n, NR_TASKLETS) * sizeof(T)) / sizeof(T)) ? : 1);
+        break;
+    default: break;
+    }
+    size_t i, curr_length, curr_size;
+    LOOP_ON_MRAM(i, curr_length, curr_size, (*range)) {
+        if (type == almost) {
+            generate_sorted_distribution_wram(cache, &cache[curr_length-1], i);
+            size_t const swaps = (param) ? : sqroot_on_dpu(curr_length);
+            for (size_t s = 0; s < swaps && curr_length > 1; s++) {
+                size_t const a = rr(curr_length, &input_rngs[me()]);
+                size_t const b = rr(curr_length, &input_rngs[me()]);
+                swap(&cache[a], &cache[b]);
+            }
+        } else {
+            for (size_t j = 0; j < curr_length; j++) {
+                cache[j] = get_element(i - range->start + j, n, type, param, step, shift);
+            }
+        }
+        mram_write(cache, &array[i], curr_size);
+    }
+}
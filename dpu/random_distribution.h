@@ -7,6 +7,7 @@
 #define _RANDOM_DISTRIBUTION_H_
 
 #include "common.h"
+#include "communication.h"
 #include "mram_loop.h"
 #include "random_generator.h"
 
@@ -87,4 +88,21 @@ void generate_reverse_sorted_distribution_mram(T __mram_ptr *array, T *cache,
 **/
 void generate_almost_sorted_distribution_wram(T *start, T *end, size_t swaps);
 
+/**
+ * @brief Draws numbers from any distribution offered by the host.
+ * Stores them in an MRAM array.
+ * The parameter has the same meaning as on the host, except for `sorted` and `reverse`,
+ * which ignore it. Also, the elements are computed independently of each other, so the swaps of `almost` stay
+ * within the chunks loaded into WRAM, the runs of `sortedruns` interleave deterministically
+ * instead of being drawn, and `zipf` and `normal` are replaced with `uniform`.
+ * 
+ * @param array The MRAM array where to store the random data.
+ * @param cache A cache in WRAM.
+ * @param range For which indices of the array the numbers are drawn.
+ * @param type The distribution to draw from.
+ * @param param What parameter is used for the distribution.
+**/
+void generate_input_distribution_mram(T __mram_ptr *array, T *cache, mram_range const *range,
+        enum dist type, T param);
+
 #endif  // _RANDOM_DISTRIBUTION_H_
@@ -38,6 +38,7 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include <seqread.h>
 
+#include "buffers.h"
 #include "common.h"
 
 #if (STRAIGHT_READER == READ_OPT)
@@ -45,6 +46,7 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #define PAGE_SIZE (2 * SEQREAD_CACHE_SIZE)
 #define PAGE_OFF_MASK (PAGE_SIZE - 1)
 #define PAGE_IDX_MASK (~PAGE_OFF_MASK)
+// The jump condition “no carry into the page index”, which the custom reader uses as well.
 #if (PAGE_SIZE == 2048)
 #define CARRY_FLAG "nc11"
 #elif (PAGE_SIZE == 1024)
@@ -63,20 +65,24 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 /**
  * @brief Equivalent to `seqread_init`.
- * Sets the WRAM and MRAM addresses of a reader and loads the data.
+ * Sets the WRAM and MRAM addresses of a reader and loads the data up to the end of the run.
  * Removed checks for whether the data is already present.
  * @internal For some reason, using `seqread_seek` broke MergeSort on reverse sorted inputs.
  * Since it is never used, it was combined with `seqread_init`.
+ * The reloads of `SR_GET` always load a full page since their size is an immediate.
  * 
  * @param cache The WRAM buffer of the sequential reader.
  * @param mram The first MRAM address to read.
  * @param reader The reader to initialise.
+ * @param end The last item of the run. Nothing after it is loaded.
  * 
  * @return The WRAM buffer address of the first MRAM item.
 **/
-static inline T *sr_init(seqreader_buffer_t cache, void __mram_ptr *mram, seqreader_t *reader) {
+static inline T *sr_init(seqreader_buffer_t cache, void __mram_ptr *mram, seqreader_t *reader,
+        T __mram_ptr const *end) {
     reader->mram_addr = (uintptr_t)mram & PAGE_IDX_MASK;
-    mram_read((void __mram_ptr *)reader->mram_addr, (void *)cache, PAGE_SIZE);
+    mram_read((void __mram_ptr *)reader->mram_addr, (void *)cache,
+            run_load_size(reader->mram_addr, end, PAGE_SIZE));
     return (T *)(cache + ((uintptr_t)mram & PAGE_OFF_MASK));
 }
 
@@ -122,8 +128,6 @@ __asm__ volatile(                                            \
     : [p] "r"(ptr), [m] "r"(mram), [w] "r"(wram)             \
 )
 
-#undef CARRY_FlAG
-
 #elif (STRAIGHT_READER == READ_STRAIGHT)
 
 #include <mram.h>
@@ -137,18 +141,21 @@ __asm__ volatile(                                            \
 #define PAGE_OFF_MASK (PAGE_SIZE - 1)
 #define PAGE_IDX_MASK (~PAGE_OFF_MASK)
 
-#define MRAM_READ_PAGE(from, to) mram_read((__mram_ptr void *)(from), (void *)(to), PAGE_ALLOC_SIZE)
+#define MRAM_READ_PAGE(from, to, end) mram_read((__mram_ptr void *)(from), (void *)(to), \
+        run_load_size(from, end, PAGE_ALLOC_SIZE))
 
 /**
- * @brief Equivalent to `seqread_init`.
+ * @brief Equivalent to `seqread_init`, but loads nothing after the end of the run.
  * 
  * @param cache The WRAM buffer of the sequential reader.
  * @param mram The first MRAM address to read.
  * @param reader The reader to initialise.
+ * @param end The last item of the run.
  * 
  * @return The WRAM buffer address of the first MRAM item.
 **/
-static inline T *sr_init(seqreader_buffer_t cache, void __mram_ptr *mram, seqreader_t *reader) {
+static inline T *sr_init(seqreader_buffer_t cache, void __mram_ptr *mram, seqreader_t *reader,
+        T __mram_ptr const *end) {
     reader->wram_cache = cache;
     reader->mram_addr = (uintptr_t)(1 << __DPU_MRAM_SIZE_LOG2);
 
@@ -158,7 +165,7 @@ static inline T *sr_init(seqreader_buffer_t cache, void __mram_ptr *mram, seqrea
     uintptr_t mram_offset = target_addr - current_addr;
     if ((mram_offset & PAGE_IDX_MASK) != 0) {
         uintptr_t target_addr_idx_page = target_addr & PAGE_IDX_MASK;
-        MRAM_READ_PAGE(target_addr_idx_page, wram_cache);
+        MRAM_READ_PAGE(target_addr_idx_page, wram_cache, end);
         mram_offset = target_addr & PAGE_OFF_MASK;
         reader->mram_addr = target_addr_idx_page;
     }
@@ -199,10 +206,13 @@ ptr = (T *)__builtin_dpu_seqread_get((uintptr_t)ptr, sizeof(T), reader, PAGE_SIZ
  * @param cache The WRAM buffer of the sequential reader.
  * @param mram The first MRAM address to read.
  * @param reader The reader to initialise.
+ * @param end (unused, the regular reader always loads a full page)
  * 
  * @return The WRAM buffer address of the first MRAM item.
 **/
-static inline T *sr_init(seqreader_buffer_t cache, void __mram_ptr *mram,  seqreader_t *reader) {
+static inline T *sr_init(seqreader_buffer_t cache, void __mram_ptr *mram, seqreader_t *reader,
+        T __mram_ptr const *end) {
+    (void)end;
     return seqread_init(cache, mram, reader);
 }
 
@@ -233,4 +243,20 @@ static inline T __mram_ptr *sr_tell(void *ptr, seqreader_t *reader, uintptr_t mr
 
 #endif  // STRAIGHT_READER == READ_REGULAR
 
+/**
+ * @brief Counts the items of a run which follow the current one.
+ * 
+ * @param ptr The current buffer item of the run.
+ * @param reader The reader of the run.
+ * @param mram The MRAM address of the current page (only used by the optimised reader).
+ * @param end The MRAM address of the last item of the run.
+ * 
+ * @return The number of items after the current one or zero if there are none.
+**/
+static inline size_t sr_items_ahead(T *ptr, seqreader_t *reader, uintptr_t mram,
+        T __mram_ptr const *end) {
+    intptr_t const ahead = (intptr_t)end - (intptr_t)sr_tell(ptr, reader, mram);
+    return (ahead > 0) ? (size_t)ahead >> DIV : 0;
+}
+
 #endif  // _READER_H_
@@ -1,35 +1,51 @@
 /**
  * @file
  * @brief Faster sequential reading of items in MRAM.
+ *
+ * Unlike þe straight readers, þese readers know þe end of þeir run.
+ * Þey can þus tell cheaply wheþer þeir buffer is nearly exhausted
+ * and never load anyþing after þe run, save for þe reloads of þe optimised variant.
 **/
 
 #ifndef _READER_CUSTOM_H_
 #define _READER_CUSTOM_H_
 
 #include <assert.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+
 #include <attributes.h>
+#include <defs.h>
 #include <mram.h>
 
+#include "buffers.h"
 #include "common.h"
+#include "reader.h"
 
-#if (STRAIGHT_READER == READ_OPT)  // Þe straight reader uses þe full buffer.
-
-/// @brief How many bytes þe sequential reader reads at once.
-#define READER_SIZE (SEQREAD_CACHE_SIZE)
-
-#elif (STRAIGHT_READER != 0)  // Þe straight reader uses only þe first half of þe buffer.
-
-/// @brief How many bytes þe sequential reader reads at once.
+/// @brief How many bytes þe sequential reader reads at once. Each reader buffer has þis size.
 #define READER_SIZE (2 * SEQREAD_CACHE_SIZE)
-
-#endif
-
 /// @brief How many items þe sequential reader reads at once.
 #define READER_LENGTH (READER_SIZE >> DIV)
 static_assert(
     !(READER_SIZE % sizeof(T)),
     "Custom reader buffers must be capable of holding a whole multiple of numbers!"
 );
+static_assert(READER_SIZE <= 2048, "Custom reader buffers must be loadable wiþ a single DMA!");
+
+#if (STRAIGHT_READER == READ_OPT) && (READER_SIZE != PAGE_SIZE)
+#error "Þe custom reader shares þe carry flag of þe optimised straight reader!"
+#endif
+
+#ifndef CUSTOM_READER
+/// @brief Wheþer MRAM sorts merge þeir runs wiþ custom readers instead of straight readers.
+#define CUSTOM_READER (false)
+#endif
+
+// Þe native build never uses þe optimised straight reader, so þis only concerns DPU builds.
+#if (CUSTOM_READER) && (STRAIGHT_READER == READ_OPT)
+#error "Þe reloads of þe custom reader under `READ_OPT` have yet to run on a DPU or þe simulator!"
+#endif
 
 /**
  * @brief A custom sequential reader which accepts a beginning and an end of an MRAM array.
@@ -57,6 +73,8 @@ struct reader {
 
 /**
  * @brief Registers þe WRAM buffer of a sequential reader. Must only be called once.
+ * @note Wiþ þe optimised straight reader, þe buffer must be aligned to `READER_SIZE`,
+ * as are þe reader buffers of all arenas.
  * 
  * @param reader Þe reader whose buffer to set.
  * @param buffer Þe address of þe buffer.
@@ -77,17 +95,20 @@ static inline void setup_reader(struct reader * const reader, uintptr_t const bu
 
 /**
  * @brief Specifying a new MRAM array to read.
+ * Noþing after þe last item is loaded, neiþer now nor by later reloads of þe C variant.
  * 
  * @param reader Þe reader wiþ which to read from þe array.
- * @param from Þe first MRAM item to read.
+ * @param from Þe first MRAM item to read. Need not be DMA-aligned.
  * @param to Þe last MRAM item to read.
 **/
-static inline void reset_reader(struct reader * const reader, T __mram_ptr *from,
-        T __mram_ptr *to) {
-    reader->from = from;
+static inline void reset_reader(struct reader * const reader, T __mram_ptr * const from,
+        T __mram_ptr * const to) {
+    // Þe buffer starts at þe last DMA-aligned address up to þe first item.
+    reader->from = (T __mram_ptr *)((uintptr_t)from & ~(uintptr_t)DMA_OFF_MASK);
     reader->to = to;
-    mram_read(reader->from, reader->buffer, READER_SIZE);
-    reader->ptr = reader->buffer;
+    mram_read(reader->from, reader->buffer,
+            run_load_size((uintptr_t)reader->from, to, READER_SIZE));
+    reader->ptr = reader->buffer + (from - reader->from);
     reader->val = *reader->ptr;
     reader->last_item = reader->buffer + (reader->to - reader->from);
 }
@@ -122,15 +143,39 @@ static inline void update_reader_partially(struct reader * const reader) {
  * @param reader Þe reader of þe respective pointer.
 **/
 static inline void update_reader_fully(struct reader * const reader) {
+#if (STRAIGHT_READER == READ_OPT) && (CUSTOM_READER)
+    // Unreachable until þe assembly has been verified, so MergeHSCustom keeps þe C reloads.
+    // As in `SR_GET`, þe increment carries over iff þe buffer is passed.
+    // Only þen, þe four instructions after it load þe next page and rewind þe pointers.
+    T *ptr = reader->ptr;
+    uintptr_t from = (uintptr_t)reader->from;
+    T *last_item = reader->last_item;
+    __asm__ volatile(
+        "add %[p], %[p], 1 << "__STR(DIV)", "CARRY_FLAG", .+5\n"
+        "add %[m], %[m], "__STR(READER_SIZE)"\n"
+        "ldma %[w], %[m], "__STR(READER_SIZE)"/8 - 1\n"
+        "add %[p], %[p], -"__STR(READER_SIZE)"\n"
+        "add %[l], %[l], -"__STR(READER_SIZE)
+        : [p] "+r"(ptr), [m] "+r"(from), [l] "+r"(last_item)
+        : [w] "r"(reader->buffer)
+        : "memory"
+    );
+    reader->ptr = ptr;
+    reader->from = (T __mram_ptr *)from;
+    reader->last_item = last_item;
+    reader->val = *ptr;
+#else
     if (reader->ptr < reader->buffer_end) {
         update_reader_partially(reader);
         return;
     }
     reader->from += READER_LENGTH;
-    mram_read(reader->from, reader->buffer, READER_SIZE);
+    mram_read(reader->from, reader->buffer,
+            run_load_size((uintptr_t)reader->from, reader->to, READER_SIZE));
     reader->ptr = reader->buffer;
     reader->val = *reader->ptr;
     reader->last_item -= READER_LENGTH;  // optimised away if not needed
+#endif
 }
 
 /**
@@ -1,21 +1,363 @@
+#include <barrier.h>
+#include <mutex.h>
+
 #include "starting_runs.h"
 #include "wram_sorts.h"
 
-void form_starting_runs(T __mram_ptr * const start, T __mram_ptr * const end) {
+/**
+ * @brief Sorts an MRAM array blockwise like `form_starting_runs`
+ * but may write the sorted blocks elsewhere.
+ * 
+ * @param start The first item of the MRAM array to sort.
+ * @param end The last item of said array.
+ * @param out Whither to write the sorted first item. May be `start` itself.
+ * 
+ * @return The length of the starting runs formed.
+**/
+static size_t form_starting_runs_into(T __mram_ptr * const start, T __mram_ptr * const end,
+        T __mram_ptr * const out) {
     T * const cache = buffers[me()].cache + SENTINELS_NUMS;
     cache[-1] = T_MIN;
+    intptr_t const run_length = starting_run_length();
     T __mram_ptr *i;
     size_t curr_length, curr_size;
     mram_range_ptr range = { start, end + 1 };
-    LOOP_BACKWARDS_ON_MRAM_BL(i, curr_length, curr_size, range, STARTING_RUN_LENGTH) {
-#if (STARTING_RUN_SIZE > 2048)
+    LOOP_BACKWARDS_ON_MRAM_BL(i, curr_length, curr_size, range, run_length) {
         mram_read_triple(i, cache, curr_size);
         wram_sort(cache, cache + curr_length - 1);
-        mram_write_triple(cache, i, curr_size);
+        mram_write_triple(cache, out + (i - start), curr_size);
+    }
+    return run_length;
+}
+
+size_t form_starting_runs(T __mram_ptr * const start, T __mram_ptr * const end) {
+    return form_starting_runs_into(start, end, start);
+}
+
+/// @brief The first item of the part of each tasklet, shared with the other tasklets.
+static T __mram_ptr * volatile part_starts[NR_TASKLETS];
+/// @brief The last item of the part of each tasklet, shared with the other tasklets.
+static T __mram_ptr * volatile part_ends[NR_TASKLETS];
+/// @brief Whither the sorted part of each tasklet is written, shared with the other tasklets.
+static T __mram_ptr * volatile part_outs[NR_TASKLETS];
+
+#if (STARTING_RUN_POOL > 1)
+
+/// @brief How many times each tasklet has entered `group_barrier`.
+static uint32_t volatile barrier_steps[NR_TASKLETS];
+
+/// @brief Keeps the compiler from moving memory accesses across the update of a shared counter.
+#define SHARED_FENCE() __asm__ volatile("" ::: "memory")
+
+/**
+ * @brief Waits until all tasklets of a group have reached the barrier as often as this tasklet.
+ * Since every counter is only written by its own tasklet, no locks are needed.
+ * 
+ * @param first The first tasklet of the group.
+ * @param members The number of tasklets in the group.
+**/
+static void group_barrier(sysname_t const first, sysname_t const members) {
+    SHARED_FENCE();
+    uint32_t const step = barrier_steps[me()] + 1;
+    barrier_steps[me()] = step;
+    for (sysname_t m = first; m < first + members; m++) {
+        while ((int32_t)(barrier_steps[m] - step) < 0)
+            SPIN_WAIT();
+    }
+    SHARED_FENCE();
+}
+
+/**
+ * @brief Counts the items of a sorted WRAM array which are less than
+ * or, if `or_equal` is set, at most a given value.
+ * 
+ * @param array The first item of the WRAM array.
+ * @param length The number of items in the array.
+ * @param value The value to compare against.
+ * @param or_equal Whether items equal to `value` are counted, too.
+ * 
+ * @return The number of such items.
+**/
+static size_t count_below(T const * const array, size_t const length, T const value,
+        bool const or_equal) {
+    size_t left = 0, right = length;
+    while (left < right) {
+        size_t const middle = left + (right - left) / 2;
+        if (array[middle] < value || (or_equal && array[middle] == value))
+            left = middle + 1;
+        else
+            right = middle;
+    }
+    return left;
+}
+
+/**
+ * @brief Splits sorted slices such that the left sides hold the `rank` least items.
+ * Equal items are taken from earlier slices first, which keeps the merge stable.
+ * 
+ * @param slices The first items of the slices.
+ * @param lengths The number of items in each slice.
+ * @param members The number of slices.
+ * @param rank The number of items on the left sides. Must be less than the total length.
+ * @param splits Whither to store the number of items on the left side of each slice.
+**/
+static void split_slices(T * const slices[], size_t const lengths[], sysname_t const members,
+        size_t const rank, size_t splits[]) {
+    // Search for the least value of which more than `rank` items are less or equal.
+    T low = T_MAX, high = T_MIN;
+    for (sysname_t k = 0; k < members; k++) {
+        if (!lengths[k]) continue;
+        if (slices[k][0] < low) low = slices[k][0];
+        if (slices[k][lengths[k] - 1] > high) high = slices[k][lengths[k] - 1];
+    }
+    while (low < high) {
+        T const middle = low + (high - low) / 2;
+        size_t count = 0;
+        for (sysname_t k = 0; k < members; k++)
+            count += count_below(slices[k], lengths[k], middle, true);
+        if (count > rank)
+            high = middle;
+        else
+            low = middle + 1;
+    }
+    // Take all lesser items and as many equal items as needed.
+    size_t needed = rank;
+    for (sysname_t k = 0; k < members; k++) {
+        splits[k] = count_below(slices[k], lengths[k], low, false);
+        needed -= splits[k];
+    }
+    for (sysname_t k = 0; k < members && needed; k++) {
+        size_t const equal = count_below(slices[k], lengths[k], low, true) - splits[k];
+        size_t const taken = (equal < needed) ? equal : needed;
+        splits[k] += taken;
+        needed -= taken;
+    }
+}
+
+/// @brief The number of leaves of the tournament tree of `merge_slices`, a power of two.
+#define POOL_LEAVES (1 << (32 - __builtin_clz(STARTING_RUN_POOL - 1)))
+
+/**
+ * @brief Checks whether the head of a slice comes before the head of another one.
+ * Depleted slices come last, and equal items are taken from earlier slices first.
+ * 
+ * @param slices The first items of the slices.
+ * @param heads The index of the next item of each slice.
+ * @param tails The index of the first item not to merge of each slice.
+ * @param a The first slice to compare. May be a padding leaf beyond the members.
+ * @param b The second slice to compare. May be a padding leaf beyond the members.
+ * 
+ * @return Whether the head of `a` wins against the head of `b`.
+**/
+static inline bool head_wins(T * const slices[], size_t const heads[], size_t const tails[],
+        sysname_t const a, sysname_t const b) {
+    if (heads[b] >= tails[b]) return true;
+    if (heads[a] >= tails[a]) return false;
+    T const val_a = slices[a][heads[a]], val_b = slices[b][heads[b]];
+    return val_a < val_b || (val_a == val_b && a < b);
+}
+
+/**
+ * @brief Merges the items of the given ranks from the sorted slices of a pool
+ * and writes them to the MRAM.
+ * A tournament tree keeps the losers of each match, so each item costs
+ * a logarithmic number of comparisons in the number of slices instead of a linear one.
+ * 
+ * @param slices The first items of the slices.
+ * @param lengths The number of items in each slice.
+ * @param members The number of slices.
+ * @param from The rank of the first item to merge.
+ * @param to The rank of the first item not to merge.
+ * @param out Whither to write the item of rank `from`.
+**/
+static void merge_slices(T * const slices[], size_t const lengths[], sysname_t const members,
+        size_t const from, size_t const to, T __mram_ptr *out) {
+    // Padding leaves are depleted from the start.
+    size_t heads[POOL_LEAVES] = { 0 }, tails[POOL_LEAVES] = { 0 };
+    if (from != 0)
+        split_slices(slices, lengths, members, from, heads);
+    size_t all = 0;
+    for (sysname_t k = 0; k < members; k++) all += lengths[k];
+    if (to == all) {
+        for (sysname_t k = 0; k < members; k++) tails[k] = lengths[k];
+    } else {
+        split_slices(slices, lengths, members, to, tails);
+    }
+    /* Play the initial tournament bottom-up. `losers[0]` holds the overall winner. */
+    sysname_t losers[POOL_LEAVES], winners[2 * POOL_LEAVES];
+    for (sysname_t k = 0; k < POOL_LEAVES; k++)
+        winners[POOL_LEAVES + k] = k;
+    for (sysname_t node = POOL_LEAVES - 1; node > 0; node--) {
+        sysname_t const left = winners[2 * node], right = winners[2 * node + 1];
+        bool const left_wins = head_wins(slices, heads, tails, left, right);
+        winners[node] = (left_wins) ? left : right;
+        losers[node] = (left_wins) ? right : left;
+    }
+    losers[0] = winners[1];
+    // Lies at the end of the arena, where QuickSort keeps its call stack while sorting the slices.
+    T * const cache = (T *)arena_end() - POOL_OUT_LENGTH;
+    size_t o = 0;
+    for (size_t r = from; r < to; r++) {
+        sysname_t winner = losers[0];
+        cache[o++] = slices[winner][heads[winner]++];
+        if (o == POOL_OUT_LENGTH) {
+            mram_write(cache, out, POOL_OUT_SIZE);
+            out += POOL_OUT_LENGTH;
+            o = 0;
+        }
+        // Replay the matches on the path of the winner with its next item.
+        for (sysname_t node = (POOL_LEAVES + winner) / 2; node > 0; node /= 2) {
+            if (head_wins(slices, heads, tails, losers[node], winner)) {
+                sysname_t const loser = winner;
+                winner = losers[node];
+                losers[node] = loser;
+            }
+        }
+        losers[0] = winner;
+    }
+    if (o)
+        mram_write(cache, out, DMA_ALIGNED(o << DIV));
+}
+
+/**
+ * @brief Returns the number of tasklets in the group of a tasklet.
+ * Only the last group may have less than `STARTING_RUN_POOL` members.
+ * 
+ * @param first The first tasklet of the group.
+ * 
+ * @return The number of members.
+**/
+static inline sysname_t group_members(sysname_t const first) {
+    return (first + STARTING_RUN_POOL <= NR_TASKLETS) ? STARTING_RUN_POOL : NR_TASKLETS - first;
+}
+
+size_t shared_run_length(sysname_t const tasklet) {
+    sysname_t const members = group_members(tasklet / STARTING_RUN_POOL * STARTING_RUN_POOL);
+    if (members == 1)
+        return RUN_LENGTH_IN(buffers[tasklet].size - STARTING_RUN_RESERVE);
+    return members * RUN_LENGTH_IN(buffers[tasklet].size - STARTING_RUN_RESERVE - POOL_OUT_SIZE);
+}
+
+size_t form_starting_runs_shared(T __mram_ptr * const start, T __mram_ptr * const end,
+        T __mram_ptr * const out) {
+    sysname_t const first = me() / STARTING_RUN_POOL * STARTING_RUN_POOL;
+    sysname_t const members = group_members(first);
+    if (members == 1)
+        return form_starting_runs_into(start, end, out);
+    sysname_t const own = me() - first;
+    intptr_t const block_length = members * pool_slice_length();
+    T *slices[STARTING_RUN_POOL] = { NULL };
+    for (sysname_t k = 0; k < members; k++)
+        slices[k] = buffers[first + k].cache + SENTINELS_NUMS;
+    slices[own][-1] = T_MIN;
+    part_starts[me()] = start;
+    part_ends[me()] = end;
+    part_outs[me()] = out;
+    group_barrier(first, members);
+
+    /* Each member sorts a slice of each block, then merges its share of the block. */
+    for (sysname_t turn = first; turn < first + members; turn++) {
+        T __mram_ptr * const part_start = part_starts[turn];
+        T __mram_ptr * const part_end = part_ends[turn];
+        T __mram_ptr * const part_out = part_outs[turn];
+        T __mram_ptr *i;
+        size_t curr_length, curr_size;
+        mram_range_ptr range = { part_start, part_end + 1 };
+        LOOP_BACKWARDS_ON_MRAM_BL(i, curr_length, curr_size, range, block_length) {
+            (void)curr_size;  // The slices are transferred individually.
+            // All slices but the last one have the same, aligned length.
+            size_t const slice_length =
+                    DMA_ALIGNED((DIV_CEIL(curr_length, members)) << DIV) >> DIV;
+            size_t lengths[STARTING_RUN_POOL];
+            for (sysname_t k = 0; k < members; k++) {
+                size_t const offset = k * slice_length;
+                lengths[k] = (offset >= curr_length) ? 0
+                        : (curr_length - offset < slice_length) ? curr_length - offset
+                        : slice_length;
+            }
+            if (lengths[own]) {
+                mram_read_triple(i + own * slice_length, slices[own],
+                        DMA_ALIGNED(lengths[own] << DIV));
+                wram_sort(slices[own], slices[own] + lengths[own] - 1);
+            }
+            group_barrier(first, members);
+            size_t const from = own * slice_length;
+            if (from < curr_length) {
+                size_t const to = (from + slice_length < curr_length)
+                        ? from + slice_length
+                        : curr_length;
+                merge_slices(slices, lengths, members, from, to,
+                        part_out + (i - part_start) + from);
+            }
+            group_barrier(first, members);
+        }
+    }
+    return block_length;
+}
+
 #else
-        mram_read(i, cache, curr_size);
-        wram_sort(cache, cache + curr_length - 1);
-        mram_write(cache, i, curr_size);
-#endif
+
+/// @brief Guards `next_block`.
+MUTEX_INIT(block_queue_mutex);
+/// @brief Lets the tasklets wait for each other before and after working through the queue.
+BARRIER_INIT(block_queue_barrier, NR_TASKLETS);
+/// @brief How many blocks of all parts have been claimed so far.
+static uint32_t next_block;
+
+/**
+ * @brief Returns the number of starting runs in the part of a tasklet.
+ * 
+ * @param owner The tasklet to whom the part belongs.
+ * @param run_length The length of the starting runs.
+ * 
+ * @return The number of starting runs.
+**/
+static size_t count_blocks(sysname_t const owner, size_t const run_length) {
+    intptr_t const length = part_ends[owner] + 1 - part_starts[owner];
+    return (length > 0) ? DIV_CEIL((size_t)length, run_length) : 0;
+}
+
+size_t shared_run_length(sysname_t const tasklet) {
+    return RUN_LENGTH_IN(buffers[tasklet].size - STARTING_RUN_RESERVE);
+}
+
+size_t form_starting_runs_shared(T __mram_ptr * const start, T __mram_ptr * const end,
+        T __mram_ptr * const out) {
+    T * const cache = buffers[me()].cache + SENTINELS_NUMS;
+    cache[-1] = T_MIN;
+    size_t const run_length = starting_run_length();
+    if (me() == 0)  // Nobody claims blocks of the previous call anymore.
+        next_block = 0;
+    part_starts[me()] = start;
+    part_ends[me()] = end;
+    part_outs[me()] = out;
+    barrier_wait(&block_queue_barrier);
+
+    /* Claim blocks until none are left. */
+    while (true) {
+        mutex_lock(block_queue_mutex);
+        size_t block = next_block++;
+        mutex_unlock(block_queue_mutex);
+        sysname_t owner = 0;
+        for (; owner < NR_TASKLETS; owner++) {
+            size_t const blocks = count_blocks(owner, run_length);
+            if (block < blocks) break;
+            block -= blocks;
+        }
+        if (owner == NR_TASKLETS) break;
+        // As in `form_starting_runs`, the blocks are aligned to the end of the part.
+        T __mram_ptr * const until = part_ends[owner] + 1 - block * run_length;
+        T __mram_ptr * const from = ((intptr_t)(until - run_length) >= (intptr_t)part_starts[owner])
+                ? until - run_length
+                : part_starts[owner];
+        size_t const length = until - from;
+        size_t const size = DMA_ALIGNED(length << DIV);
+        mram_read_triple(from, cache, size);
+        wram_sort(cache, cache + length - 1);
+        mram_write_triple(cache, part_outs[owner] + (from - part_starts[owner]), size);
     }
+    barrier_wait(&block_queue_barrier);
+    return run_length;
 }
+
+#endif  // STARTING_RUN_POOL > 1
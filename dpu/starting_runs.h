@@ -14,30 +14,49 @@
 #include "buffers.h"
 #include "mram_loop.h"
 
-#if (STABLE)
+#ifndef SPIN_WAIT
+/// @brief What a tasklet does while waiting for another one. On the DPU, it simply polls again.
+#define SPIN_WAIT()
+#endif
 
-/// @brief The number of items in the starting runs.
-#define STARTING_RUN_LENGTH ((((TRIPLE_BUFFER_LENGTH - SENTINELS_NUMS) / 2) >> DIV) << DIV)
-
-#else
-
-/// @brief The number of items in the starting runs.
-#define STARTING_RUN_LENGTH (TRIPLE_BUFFER_LENGTH - SENTINELS_NUMS)
-
-#endif  // STABLE
-
-/// @brief The number of bytes a starting run takes.
-#define STARTING_RUN_SIZE (STARTING_RUN_LENGTH << DIV)
 static_assert(
-    STARTING_RUN_SIZE == DMA_ALIGNED(STARTING_RUN_SIZE),
-    "The size of starting runs must be properly aligned for DMAs!"
+    sizeof(T *) == WRAM_POINTER_SIZE,
+    "The call stack of QuickSort would not fit into `STARTING_RUN_RESERVE`!"
+);
+static_assert(
+    STARTING_RUN_POOL >= 1 && STARTING_RUN_POOL <= NR_TASKLETS,
+    "A pool must consist of at least one and at most all tasklets!"
+);
+// The arenas are sized at runtime but always aligned, so the runs sorted in them are, too.
+static_assert(
+    STARTING_RUN_RESERVE == DMA_ALIGNED(STARTING_RUN_RESERVE)
+            && POOL_OUT_SIZE == DMA_ALIGNED(POOL_OUT_SIZE),
+    "The sizes of starting runs and pooled slices must be properly aligned for DMAs!"
 );
 static_assert(
-    STARTING_RUN_SIZE <= (TRIPLE_BUFFER_SIZE - SENTINELS_SIZE),
-    "The starting runs are sorted entirely in WRAM and, thus, must fit in there!"
+    RUN_LENGTH_IN(TRIPLE_BUFFER_SIZE - STARTING_RUN_RESERVE - POOL_OUT_SIZE) > 0,
+    "Even an arena no larger than a triple buffer must hold a pooled slice!"
 );
 
-extern triple_buffers buffers[NR_TASKLETS];
+/**
+ * @brief Returns the number of items in the starting runs which a tasklet forms on its own.
+ * Since they fill the whole arena, their length is only known at runtime.
+ * 
+ * @return The length of the starting runs.
+**/
+static inline size_t starting_run_length(void) {
+    return RUN_LENGTH_IN(buffers[me()].size - STARTING_RUN_RESERVE);
+}
+
+/**
+ * @brief Returns the number of items which each tasklet of a pool sorts in its arena.
+ * Like the starting runs, they fill the whole arena except for the output cache.
+ * 
+ * @return The length of the slices.
+**/
+static inline size_t pool_slice_length(void) {
+    return RUN_LENGTH_IN(buffers[me()].size - STARTING_RUN_RESERVE - POOL_OUT_SIZE);
+}
 
 /**
  * @brief Scans an MRAM array backwards blockwise,
@@ -45,8 +64,40 @@ extern triple_buffers buffers[NR_TASKLETS];
  * 
  * @param start The first item of the MRAM array to sort.
  * @param end The last item of said array.
+ * 
+ * @return The length of the starting runs formed.
+**/
+size_t form_starting_runs(T __mram_ptr *start, T __mram_ptr *end);
+
+/**
+ * @brief Returns the length of the starting runs which `form_starting_runs_shared` forms
+ * in the part of a tasklet, so that callers may plan their merge passes beforehand.
+ * 
+ * @param tasklet The tasklet to whom the part belongs.
+ * 
+ * @return The length of the starting runs.
+**/
+size_t shared_run_length(sysname_t tasklet);
+
+/**
+ * @brief Forms the starting runs of all tasklets together.
+ * If `STARTING_RUN_POOL` is one, the tasklets claim the blocks of all parts one by one
+ * from a shared queue, so that no tasklet idles while another one still sorts expensive blocks.
+ * Otherwise, the starting runs get longer than an arena
+ * by letting groups of `STARTING_RUN_POOL` neighbouring tasklets work on one block at a time.
+ * Each tasklet sorts a slice of the block in its WRAM,
+ * after which each tasklet merges its share of all slices of the group back into the MRAM.
+ * The group works through the parts of all its members, one after the other.
+ * A group of only one tasklet falls back to `form_starting_runs`.
+ * @note Must be called by all tasklets at once.
+ * 
+ * @param start The first item of the MRAM array to sort.
+ * @param end The last item of said array.
+ * @param out Whither to write the sorted first item. May be `start` itself.
+ * 
+ * @return The length of the starting runs formed.
 **/
-void form_starting_runs(T __mram_ptr *start, T __mram_ptr *end);
+size_t form_starting_runs_shared(T __mram_ptr *start, T __mram_ptr *end, T __mram_ptr *out);
 
 /**
  * @brief Copies a sorted MRAM array to another MRAM location.
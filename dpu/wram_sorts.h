@@ -7,8 +7,69 @@
 #define _BASE_SORT_H_
 
 #include <stdbool.h>
+
+#include "buffers.h"
 #include "common.h"
 
+#ifdef UINT32
+
+/**
+ * @brief Inserts a single item into the sorted items before it.
+ * @attention Relies on a sentinel value before the sorted items, as does `insertion_sort_wram`.
+ *
+ * @param curr The item to insert. All items before it must already be sorted.
+**/
+static inline void insert_single_wram(T *curr) {
+    T const to_sort = *curr;
+    while (*(curr - 1) > to_sort) {
+        *curr = *(curr - 1);
+        curr--;
+    }
+    *curr = to_sort;
+}
+
+/**
+ * @brief An implementation of InsertionSort which inserts two items at a time.
+ * Both are fetched with a single 64-bit load. The greater one is inserted first,
+ * with all greater items moving by two places, the lesser one continues from there.
+ * @attention This algorithm relies on `start[-1]` being a sentinel value,
+ * i.e. being at least as small as any value in the array.
+ * For this reason, `cache[-1]` is set to `T_MIN`.
+ * For QuickSort, the last value of the previous partition takes on that role.
+ *
+ * @param start The first element of the WRAM array to sort.
+ * @param end The last element of said array.
+**/
+static void insertion_sort_wram(T * const start, T * const end) {
+    T *i = start + 1;
+    if (((uintptr_t)i & (sizeof(T_pair) - 1)) && i <= end)  // Pairs must be 64-bit aligned.
+        insert_single_wram(i++);
+    for (; i < end; i += 2) {
+        T lesser, greater;
+        load_pair(i, &lesser, &greater);
+        if (greater < lesser) {  // Equal items are not swapped so that the sort remains stable.
+            T const temp = lesser;
+            lesser = greater;
+            greater = temp;
+        }
+        T *curr = i + 1;
+        while (*(curr - 2) > greater) {  // `-2` always valid due to the sentinel value
+            *curr = *(curr - 2);
+            curr--;
+        }
+        *curr-- = greater;
+        while (*(curr - 1) > lesser) {
+            *curr = *(curr - 1);
+            curr--;
+        }
+        *curr = lesser;
+    }
+    if (i == end)
+        insert_single_wram(i);
+}
+
+#else  // UINT32
+
 /**
  * @brief An implementation of standard InsertionSort.
  * @attention This algorithm relies on `start[-1]` being a sentinel value,
@@ -31,6 +92,8 @@ static void insertion_sort_wram(T * const start, T * const end) {
     }
 }
 
+#endif  // UINT32
+
 #if (STABLE)
 
 #define __MERGE_THRESHOLD__ (14)
@@ -123,6 +186,59 @@ static inline void copy_full_run_wram(T *in, T *until, T *out) {
 **/
 #define UNROLL_FACTOR_WRAM (MIN(__MERGE_THRESHOLD__, 16))
 
+#ifdef UINT32
+
+/**
+ * @brief Takes the lesser current item of the two runs and advances the run it came from.
+ *
+ * @param dest Whither to store the item.
+**/
+#define TAKE_LESSER_WRAM(dest) \
+if (val_i <= val_j) {          \
+    dest = val_i;              \
+    val_i = *++i;              \
+} else {                       \
+    dest = val_j;              \
+    val_j = *++j;              \
+}
+
+/**
+ * @brief Merges the two runs within the merger functions in unrolled loops.
+ * The full unrolled loops write their items in pairs through 64-bit stores,
+ * for which a single item is merged beforehand if `out` is not 64-bit aligned.
+ * @note `UNROLL_FACTOR_WRAM` must be even.
+ * 
+ * @param ptr The pointer of the run whose last element is less than that of the other run.
+ * @param end The address of said last element.
+ * @param on_depletion An if-block for when and what to do if said run is fully merged.
+**/
+#define UNROLLED_MERGER_WRAM(ptr, end, on_depletion)      \
+if ((uintptr_t)out & (sizeof(T_pair) - 1)) {              \
+    TAKE_LESSER_WRAM(*out++);                             \
+    on_depletion                                          \
+}                                                         \
+while (ptr <= end - UNROLL_FACTOR_WRAM + 1) {             \
+    _Pragma("unroll")                                     \
+    for (size_t k = 0; k < UNROLL_FACTOR_WRAM; k += 2) {  \
+        T first, second;                                  \
+        TAKE_LESSER_WRAM(first);                          \
+        TAKE_LESSER_WRAM(second);                         \
+        store_pair(out + k, first, second);               \
+    }                                                     \
+    out += UNROLL_FACTOR_WRAM;                            \
+};                                                        \
+on_depletion                                              \
+while (ptr <= end - (UNROLL_FACTOR_WRAM / 2) + 1) {       \
+    _Pragma("unroll")                                     \
+    for (size_t k = 0; k < UNROLL_FACTOR_WRAM / 2; k++) { \
+        TAKE_LESSER_WRAM(*(out + k));                     \
+    }                                                     \
+    out += UNROLL_FACTOR_WRAM / 2;                        \
+}                                                         \
+on_depletion
+
+#else  // UINT32
+
 /**
  * @brief Merges the two runs within the merger functions in unrolled loops.
  * 
@@ -160,6 +276,8 @@ while (ptr <= end - (UNROLL_FACTOR_WRAM / 2) + 1) {       \
 }                                                         \
 on_depletion
 
+#endif  // UINT32
+
 /**
  * @brief Merges two runs ranging from [`start_1`, `end_1`] and [`start_2`, `end_2`].
  * If the second run is depleted, the first one will not be flushed.
@@ -300,16 +418,14 @@ swap(i, right)
 
 #define __RECURSIVE__ (false)
 
-static T *call_stacks[NR_TASKLETS][40];  // call stack for iter. QuickSort
-
 // A “call” stack for holding the values of `left` and `right` is maintained.
-// Its memory must be reserved beforehand.
-#define QUICK_HEAD()                                    \
-T ** const start_of_call_stack = &call_stacks[me()][0]; \
-T **call_stack = start_of_call_stack;                   \
-*call_stack++ = start;                                  \
-*call_stack++ = end;                                    \
-do {                                                    \
+// It lies at the end of the arena of the tasklet, which the array to sort must leave free.
+#define QUICK_HEAD()                                                    \
+T ** const start_of_call_stack = (T **)arena_end() - CALL_STACK_LENGTH; \
+T **call_stack = start_of_call_stack;                                   \
+*call_stack++ = start;                                                  \
+*call_stack++ = end;                                                    \
+do {                                                                    \
     T *right = *--call_stack, *left = *--call_stack
 
 // Closing the loop which pops from the stack.
@@ -1,4 +1,5 @@
 #include <math.h>
+#include <stddef.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -8,8 +9,14 @@
 
 #include "common.h"
 #include "communication.h"
+#include "cost_model.h"
+#include "cpu_sorts.h"
+#include "input_file.h"
 #include "params.h"
 #include "random_distribution.h"
+#include "statistics.h"
+#include "transfers.h"
+#include "verification.h"
 
 // Sanity Checks
 #if (CACHE_SIZE % DMA_ALIGNMENT)
@@ -21,8 +28,8 @@
 #if (NR_DPUS != 1)
 #error Only one DPU can be used!
 #endif
-#if (NR_TASKLETS <= 0 || NR_TASKLETS > 16)
-#error The number of tasklets must be between 1 and 16!
+#if (NR_TASKLETS <= 0 || NR_TASKLETS > 24)
+#error The number of tasklets must be between 1 and 24!
 #endif
 
 /**
@@ -41,8 +48,11 @@ static void free_dpus(struct dpu_set_t set) {
  *
  * @param set The set of DPUs to load.
  * @param mode The mode/benchmark Id passed via the CLI.
+ * @param simulator Whether to allocate simulated DPUs instead of actual ones.
+ * @param nr_of_dpus How many DPUs to allocate.
 **/
-static void alloc_dpus(struct dpu_set_t *set, unsigned const mode) {
+static void alloc_dpus(struct dpu_set_t *set, unsigned const mode, bool const simulator,
+        uint32_t const nr_of_dpus) {
     char binaries[] = BINARIES, *binary = strtok(binaries, ",");
     unsigned found_binaries = 0;
     while ((binary != NULL) && (found_binaries++ != mode)) {
@@ -52,7 +62,7 @@ static void alloc_dpus(struct dpu_set_t *set, unsigned const mode) {
         printf("‘%u’ is no known benchmark Id!\n", mode);
         abort();
     }
-    DPU_ASSERT(dpu_alloc(1, NULL, set));
+    DPU_ASSERT(dpu_alloc(nr_of_dpus, (simulator) ? "backend=simulator" : NULL, set));
     DPU_ASSERT(dpu_load(*set, binary, NULL));
 }
 
@@ -96,51 +106,78 @@ static uint32_t *get_lengths(char lengths[], size_t nr_of_lengths) {
     return ns;
 }
 
+/**
+ * @brief Lets only the given number of tasklets sort, each an equally long part.
+ * If the input is so short that the last tasklets would get no items, fewer tasklets sort.
+ *
+ * @param host_to_dpu The input data to send to the DPU, whose `length` must be set.
+ * @param active How many tasklets sort at most, from 1 to `NR_TASKLETS`.
+**/
+static void set_active_tasklets(struct dpu_arguments *host_to_dpu, uint32_t const active) {
+    host_to_dpu->part_length =
+            DMA_ALIGNED(DIV_CEIL(host_to_dpu->length, active) * sizeof(T)) / sizeof(T);
+    host_to_dpu->active_tasklets = DIV_CEIL(host_to_dpu->length, host_to_dpu->part_length);
+}
+
 /**
  * @brief Launches the program to execute the current sorting function once.
  * 
  * @param set The set with the DPU.
  * @param host_to_dpu The input data to send to the DPU.
- * @param dpu_to_host What the DPU has sent so far.
+ * @param dpu_to_host Where to store what the DPU has sent, that is,
+ * the layout of the sorted data and the measured time of each repetition.
+ * If `NULL`, the results are discarded.
 **/
 static void test(struct dpu_set_t *set, struct dpu_arguments *host_to_dpu,
         struct dpu_results *dpu_to_host) {
     struct dpu_set_t dpu;
-    struct dpu_results new_result;
     DPU_FOREACH(*set, dpu) {
         DPU_ASSERT(dpu_copy_to(dpu, "host_to_dpu", 0, host_to_dpu, sizeof *host_to_dpu));
         DPU_ASSERT(dpu_launch(*set, DPU_SYNCHRONOUS));
-        DPU_ASSERT(dpu_copy_from(dpu, "dpu_to_host", 0, &new_result, sizeof new_result));
+        if (dpu_to_host != NULL)
+            DPU_ASSERT(dpu_copy_from(dpu, "dpu_to_host", 0, dpu_to_host,
+                    offsetof(struct dpu_results, times) + sizeof(dpu_time[host_to_dpu->reps])));
         // DPU_ASSERT(dpu_log_read(dpu, stdout));
     }
-    dpu_to_host->firsts += new_result.firsts;
-    dpu_to_host->seconds += new_result.seconds;
 }
 
 /**
- * @brief The arithmetic mean of measured times.
- * 
- * @param zeroth The zeroth moment, that is, the number of measurements.
- * @param first The first moment, that is, the sum of measured times.
+ * @brief Downloads the sorted data of all repetitions from wherever the DPU has left them.
  * 
- * @return The mean time.
+ * @param dpu The DPU which has sorted the data.
+ * @param sorted Whither to download the data.
+ * @param host_to_dpu The input data sent to the DPU.
+ * @param dpu_to_host What the DPU has sent back, including the location of each sorted part.
+ * @param transferred The number of bytes uploaded to the DPU.
 **/
-static dpu_time get_mean_of_time(dpu_time const zeroth, dpu_time const first) {
-    return first / zeroth;
+static void download_sorted(struct dpu_set_t dpu, T sorted[],
+        struct dpu_arguments const *host_to_dpu, struct dpu_results const *dpu_to_host,
+        size_t const transferred) {
+    if (!dpu_to_host->parts_in_output) {
+        DPU_ASSERT(dpu_copy_from(dpu, "input", 0, sorted, transferred));
+        return;
+    }
+    for (uint32_t rep = 0; rep < host_to_dpu->reps; rep++) {
+        for (uint32_t part = 0; part < dpu_to_host->sorted_parts; part++) {
+            size_t from, to;
+            get_part_range(dpu_to_host->sorted_length, host_to_dpu->part_length,
+                    dpu_to_host->sorted_parts, part, &from, &to);
+            if (from == to) continue;
+            char const *symbol = (dpu_to_host->parts_in_output >> part & 1) ? "output" : "input";
+            size_t const first = (size_t)rep * host_to_dpu->offset + from;
+            DPU_ASSERT(dpu_copy_from(dpu, symbol, first * sizeof(T), &sorted[first],
+                    DMA_ALIGNED((to - from) * sizeof(T))));
+        }
+    }
 }
 
 /**
- * @brief The standard deviation of measured times.
- * 
- * @param zeroth The zeroth moment, that is, the number of measurements.
- * @param first The first moment, that is, the sum of measured times.
- * @param second The second moment, that is, the sum of squared measured times.
+ * @brief Prints the names of the columns holding the statistics of one sorting algorithm.
  * 
- * @return The standard deviation.
+ * @param name The name of the sorting algorithm.
 **/
-static dpu_time get_std_of_time(dpu_time const zeroth, dpu_time const first, dpu_time second) {
-    if (zeroth == 1) return 0;
-    return sqrt((zeroth * second - first * first) / (zeroth * (zeroth - 1)));
+static void print_column_names(char const * const name) {
+    printf("\tµ_%s σ_%s med_%s p5_%s p95_%s cil_%s cih_%s", name, name, name, name, name, name, name);
 }
 
 /**
@@ -148,54 +185,95 @@ static dpu_time get_std_of_time(dpu_time const zeroth, dpu_time const first, dpu
  * 
  * @param algos A list of sorting algorithms and their names.
  * @param num_of_algos The length of the list.
+ * @param num_of_cpu_algos_used How many of the CPU sorting algorithms are run as well.
  * @param args The arguments with which the program was started,
  * including the number of repetitions and the upper bound for random numbers.
+ * If the cost model is used, a column with the prediction and one with its relative error
+ * are printed for each DPU algorithm.
 **/
 static void print_header(union algo_to_test const algos[], size_t const num_of_algos,
-        struct Params *params) {
+        size_t const num_of_cpu_algos_used, struct Params *params) {
     printf(
-        "# reps=%u, dist name=%s, dist param=%"T_QUALIFIER", TYPE=%s, CACHE_SIZE=%d, "
-        "SEQREAD_CACHE_SIZE=%d, NR_TASKLETS=%d, CALL_OVERHEAD=%u\n# %s\n",
+        "# reps=%u, warm-ups=%u, dist name=%s, dist param=%"T_QUALIFIER", TYPE=%s, CACHE_SIZE=%d, "
+        "SEQREAD_CACHE_SIZE=%d, NR_TASKLETS=%d, CALL_OVERHEAD=%u, DPU_FREQUENCY=%u\n# %s\n",
         params->n_reps,
-        get_dist_name(params->dist_type),
+        params->n_warmups,
+        (params->file != NULL) ? params->file : get_dist_name(params->dist_type),
         params->dist_param,
         TYPE_NAME,
         CACHE_SIZE,
         SEQREAD_CACHE_SIZE,
         NR_TASKLETS,
         CALL_OVERHEAD,
+        DPU_FREQUENCY,
         TABLE_HEADER
     );
     printf("n");
     for (size_t i = 0; i < num_of_algos; i++)
-        printf("\tµ_%s σ_%s", algos[i].data.name, algos[i].data.name);
+        print_column_names(algos[i].data.name);
+    for (size_t i = 0; i < num_of_cpu_algos_used; i++)
+        print_column_names(cpu_algos[i].name);
+    for (size_t i = 0; i < num_of_cpu_algos_used; i++)
+        printf("\tspd_%s", cpu_algos[i].name);
+    for (size_t i = 0; params->model && i < num_of_algos; i++)
+        printf("\tpred_%s err_%s", algos[i].data.name, algos[i].data.name);
     printf("\n");
 }
 
 /**
- * @brief Prints the average of the measured runtimes and their standard deviation to the console.
- * Additionally prints the average on a per-element basis if not using the file-friendly format.
+ * @brief Prints the mean and standard deviation of the measured runtimes to the console,
+ * followed by their median, their 5th and 95th percentile,
+ * and the 95 % bootstrap confidence interval of the median.
+ * If CPU sorting algorithms were run, their times are printed likewise, converted into DPU cycles.
+ * Lastly, the speedup of the fastest DPU algorithm over each CPU algorithm is printed,
+ * which is the ratio of their medians.
+ * If predictions of the cost model are given, they are printed at the end,
+ * each followed by its error relative to the measured median.
  * 
- * @param num_of_algos The number of sorting algorithms measured.
+ * @param num_of_algos The number of sorting algorithms measured on the DPU.
+ * @param num_of_cpu_algos_used The number of sorting algorithms measured on the CPU.
  * @param length The number of input elements which were sorted.
  * @param reps How often each test was repeated.
- * @param dpu_to_host The results as measured by the DPUs.
+ * @param samples The measured times, one list per algorithm, with the DPU algorithms coming first.
+ * @param predictions The predicted times of the DPU algorithms or `NULL` if none are to be printed.
 **/
-static void print_measurements(size_t const num_of_algos, size_t const length, dpu_time const reps,
-        struct dpu_results dpu_to_host[]) {
+static void print_measurements(size_t const num_of_algos, size_t const num_of_cpu_algos_used,
+        size_t const length, uint32_t const reps, dpu_time *samples[],
+        double const predictions[]) {
     printf("%-4zd", length);
-    for (size_t id = 0; id < num_of_algos; id++) {
-        dpu_time mean = get_mean_of_time(reps, dpu_to_host[id].firsts);
-        dpu_time std = get_std_of_time(reps, dpu_to_host[id].firsts, dpu_to_host[id].seconds);
-        printf("\t%7lu %5lu", mean, std);
+    double fastest_dpu_median = 0;
+    double dpu_medians[num_of_algos];
+    double cpu_medians[num_of_cpu_algos_used + 1];
+    for (size_t id = 0; id < num_of_algos + num_of_cpu_algos_used; id++) {
+        struct summary s;
+        summarise_times(samples[id], reps, &s);
+        printf("\t%9.1f %7.1f %9.1f %9.1f %9.1f %9.1f %9.1f",
+                s.mean, s.std, s.median, s.p5, s.p95, s.ci_low, s.ci_high);
+        if (id >= num_of_algos) {
+            cpu_medians[id - num_of_algos] = s.median;
+            continue;
+        }
+        dpu_medians[id] = s.median;
+        if (id == 0 || s.median < fastest_dpu_median)
+            fastest_dpu_median = s.median;
     }
+    for (size_t id = 0; id < num_of_cpu_algos_used; id++)
+        printf("\t%6.2f", (fastest_dpu_median > 0) ? cpu_medians[id] / fastest_dpu_median : 0);
+    for (size_t id = 0; predictions != NULL && id < num_of_algos; id++)
+        printf("\t%9.1f %6.3f", predictions[id],
+                (dpu_medians[id] > 0) ? (predictions[id] - dpu_medians[id]) / dpu_medians[id] : 0);
     printf("\n");
 }
 
 int main(int argc, char **argv) {
     struct Params p = input_params(argc, argv);
     struct dpu_set_t set, dpu;
-    alloc_dpus(&set, p.mode);
+    alloc_dpus(&set, p.mode, p.simulator, 1);
+    if (p.active_tasklets > NR_TASKLETS) {
+        printf("%u tasklets cannot be active! The maximum is %u.\n", p.active_tasklets,
+                NR_TASKLETS);
+        abort();
+    }
 
     /* Read in test data. */
     uint32_t num_of_algos;
@@ -209,17 +287,81 @@ int main(int argc, char **argv) {
 
     /* Set up tests. */
     T * const input = malloc(sizeof(T[LOAD_INTO_MRAM]));
-    struct dpu_results *dpu_to_host = malloc(sizeof(struct dpu_results[num_of_algos]));
+    size_t const num_of_cpu_algos_used = (p.cpu_baselines) ? num_of_cpu_algos : 0;
+    T * const cpu_array = (p.cpu_baselines) ? malloc(sizeof(T[LOAD_INTO_MRAM])) : NULL;
+    T * const cpu_aux = (p.cpu_baselines) ? malloc(sizeof(T[LOAD_INTO_MRAM])) : NULL;
+    dpu_time **samples = malloc(sizeof(dpu_time *[num_of_algos + num_of_cpu_algos_used]));
+    for (uint32_t id = 0; id < num_of_algos + num_of_cpu_algos_used; id++)
+        samples[id] = malloc(sizeof(dpu_time[p.n_reps]));
     struct dpu_arguments host_to_dpu = {
         .basic_seed = 0b1011100111010,
+        .write_back = p.verify,
     };
+    struct dpu_results dpu_to_host;
+    struct verification jobs[2];  // One is checked while the next output is produced.
+    size_t next_job = 0, failures = 0;
+    if (p.verify) {
+        init_verification(&jobs[0]);
+        init_verification(&jobs[1]);
+    }
     srand((unsigned)1961071919591017);
 
+    struct input_file file = { 0 };
+    char default_length[24] = "512";
+    if (p.file != NULL) {
+        open_input_file(&file, p.file, p.file_offset, p.file_length);
+        snprintf(default_length, sizeof default_length, "%zu",
+                (file.length < LOAD_INTO_MRAM) ? file.length : (size_t)LOAD_INTO_MRAM);
+    }
+    if (p.lengths == NULL)
+        p.lengths = default_length;
+
+    struct cost_model model;
+    double * const predictions = (p.model) ? malloc(sizeof(double[num_of_algos])) : NULL;
+    uint32_t * const active = malloc(sizeof(uint32_t[num_of_algos]));
+    init_cost_model(&model);
+    if (p.calibration != NULL)
+        read_cost_model(&model, p.calibration);
+    if (p.mode >= 4 && p.mode <= 7) {  // Only the DPU knows how much WRAM its MRAM sorts get.
+        host_to_dpu.reps = host_to_dpu.length = 1;
+        host_to_dpu.offset = DMA_ALIGNED(sizeof(T)) / sizeof(T);
+        host_to_dpu.algo_index = 0;
+        set_active_tasklets(&host_to_dpu, 1);
+        test(&set, &host_to_dpu, &dpu_to_host);
+        model.starting_run_length = dpu_to_host.starting_run_length;
+        printf("# starting run length=%u\n", dpu_to_host.starting_run_length);
+    }
+
     size_t num_of_lengths = get_num_of_lengths(p.lengths);
     uint32_t *lengths = get_lengths(p.lengths, num_of_lengths);
 
+    /* Measure transfers. */
+    if (p.transfer_dpus != 0) {
+        double * const sort_cycles = malloc(sizeof(double[num_of_lengths]));
+        for (size_t li = 0; li < num_of_lengths; li++) {  // The fastest algorithm is offloaded.
+            sort_cycles[li] = NAN;
+            for (uint32_t id = 0; id < num_of_algos; id++) {
+                char const * const name = algos[id].data.name;
+                unsigned const tasklets = (p.active_tasklets == 0) ?
+                        fastest_tasklets(&model, p.mode, name, lengths[li]) :
+                        p.active_tasklets;
+                double const cycles = predict_cycles(&model, p.mode, name, lengths[li], tasklets);
+                if (!(cycles >= sort_cycles[li]))
+                    sort_cycles[li] = cycles;
+            }
+        }
+        for (uint32_t nr_of_dpus = 1; nr_of_dpus <= p.transfer_dpus; nr_of_dpus *= 2) {
+            struct dpu_set_t transfer_set;
+            alloc_dpus(&transfer_set, p.mode, p.simulator, nr_of_dpus);
+            benchmark_transfers(transfer_set, nr_of_dpus, p.n_reps, lengths, sort_cycles,
+                    num_of_lengths);
+            free_dpus(transfer_set);
+        }
+        free(sort_cycles);
+    }
+
     /* Perform tests. */
-    print_header(algos, num_of_algos, &p);
+    print_header(algos, num_of_algos, num_of_cpu_algos_used, &p);
     for (uint32_t li = 0; li < num_of_lengths; li++) {
         uint32_t const len = lengths[li], offset = DMA_ALIGNED(len * sizeof(T)) / sizeof(T);
         if (len > LOAD_INTO_MRAM) {
@@ -228,36 +370,104 @@ int main(int argc, char **argv) {
         }
         host_to_dpu.length = len;
         host_to_dpu.offset = offset;
-        host_to_dpu.part_length = DMA_ALIGNED(DIV_CEIL(len, NR_TASKLETS) * sizeof(T)) / sizeof(T);
+        for (uint32_t id = 0; id < num_of_algos; id++)  // WRAM sorts ignore the count anyway.
+            active[id] = (p.active_tasklets == 0) ?
+                    fastest_tasklets(&model, p.mode, algos[id].data.name, len) :
+                    p.active_tasklets;
 
-        memset(dpu_to_host, 0, sizeof(struct dpu_results[num_of_algos]));
-        uint32_t const reps_per_launch = LOAD_INTO_MRAM / len;
+        uint32_t const reps_per_launch = (LOAD_INTO_MRAM / len > MAX_REPS_PER_LAUNCH) ?
+                MAX_REPS_PER_LAUNCH :
+                LOAD_INTO_MRAM / len;
         for (uint32_t rep = 0; rep < p.n_reps; rep += reps_per_launch) {
             host_to_dpu.reps = (reps_per_launch > (p.n_reps - rep)) ?
                     p.n_reps - rep :
                     reps_per_launch;
 
-            for (uint32_t i = 0; i < host_to_dpu.reps; i++) {
-                generate_input_distribution(&input[i * offset], len, p.dist_type, p.dist_param);
+            T const *inputs = input;
+            if (p.file == NULL) {
+                for (uint32_t i = 0; i < host_to_dpu.reps; i++) {
+                    generate_input_distribution(&input[i * offset], len, p.dist_type, p.dist_param);
+                }
+            } else {
+                inputs = read_input_file(&file, input, len, offset, host_to_dpu.reps);
             }
             size_t const transferred = DMA_ALIGNED(sizeof(T[offset * host_to_dpu.reps]));
-            DPU_ASSERT(dpu_copy_to(dpu, "input", 0, input, transferred));
+            DPU_ASSERT(dpu_copy_to(dpu, "input", 0, inputs, transferred));
+
+            // MRAM sorts and write-backs overwrite the input, so it is restored before each launch.
+            bool input_overwritten = false;
+            if (rep == 0) {  // Warm up on the first inputs.
+                for (uint32_t w = 0; w < p.n_warmups; w++) {
+                    for (uint32_t id = 0; id < num_of_algos; id++) {
+                        if (input_overwritten)
+                            DPU_ASSERT(dpu_copy_to(dpu, "input", 0, inputs, transferred));
+                        host_to_dpu.algo_index = id;
+                        set_active_tasklets(&host_to_dpu, active[id]);
+                        test(&set, &host_to_dpu, NULL);
+                        input_overwritten = true;
+                    }
+                }
+            }
 
             for (uint32_t id = 0; id < num_of_algos; id++) {
+                if (input_overwritten)
+                    DPU_ASSERT(dpu_copy_to(dpu, "input", 0, inputs, transferred));
                 host_to_dpu.algo_index = id;
-                test(&set, &host_to_dpu, &dpu_to_host[id]);
+                set_active_tasklets(&host_to_dpu, active[id]);
+                active[id] = host_to_dpu.active_tasklets;  // The cost model needs the actual count.
+                test(&set, &host_to_dpu, &dpu_to_host);
+                input_overwritten = true;
+                memcpy(&samples[id][rep], dpu_to_host.times, sizeof(dpu_time[host_to_dpu.reps]));
+                if (p.verify) {  // Check the output while the next sorting algorithm runs.
+                    struct verification * const job = &jobs[next_job];
+                    next_job ^= 1;
+                    failures += finish_verification(job);
+                    download_sorted(dpu, job->sorted, &host_to_dpu, &dpu_to_host, transferred);
+                    start_verification(job, inputs, algos[id].data.name, &host_to_dpu, &dpu_to_host);
+                }
+            }
+            if (p.verify) {  // The inputs are about to be overwritten and the CPU sorts timed.
+                failures += finish_verification(&jobs[0]);
+                failures += finish_verification(&jobs[1]);
+            }
+
+            for (size_t c = 0; c < num_of_cpu_algos_used; c++) {
+                sort_algo_cpu * const cpu_algo = cpu_algos[c].fct;
+                if (rep == 0) {
+                    for (uint32_t w = 0; w < p.n_warmups; w++)
+                        time_cpu_sort(cpu_algo, inputs, cpu_array, cpu_aux, len);
+                }
+                for (uint32_t i = 0; i < host_to_dpu.reps; i++)
+                    samples[num_of_algos + c][rep + i] =
+                            time_cpu_sort(cpu_algo, &inputs[i * offset], cpu_array, cpu_aux, len);
             }
             host_to_dpu.basic_seed += host_to_dpu.reps * NR_TASKLETS;
         }
-        print_measurements(num_of_algos, len, p.n_reps, dpu_to_host);
+        for (uint32_t id = 0; p.model && id < num_of_algos; id++)
+            predictions[id] = predict_cycles(&model, p.mode, algos[id].data.name, len, active[id]);
+        print_measurements(num_of_algos, num_of_cpu_algos_used, len, p.n_reps, samples, predictions);
     }
+    if (p.verify)
+        printf("# verification: %zu incorrectly sorted part(s)\n", failures);
 
     /* Clean up. */
     free_dpus(set);
+    if (p.file != NULL)
+        close_input_file(&file);
     free(algos);
     free(lengths);
     free(input);
-    free(dpu_to_host);
+    free(cpu_array);
+    free(cpu_aux);
+    for (uint32_t id = 0; id < num_of_algos + num_of_cpu_algos_used; id++)
+        free(samples[id]);
+    free(samples);
+    free(predictions);
+    free(active);
+    if (p.verify) {
+        free_verification(&jobs[0]);
+        free_verification(&jobs[1]);
+    }
 
-    return EXIT_SUCCESS;
+    return (failures) ? EXIT_FAILURE : EXIT_SUCCESS;
 }
@@ -0,0 +1,278 @@
+#include <ctype.h>
+#include <math.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "buffer_sizes.h"
+#include "cost_model.h"
+
+/// @brief The least number of items in the starting runs, reached by arenas the size of a triple
+/// buffer. The runs are longer if tasklets pool their WRAM, whose output caches then take space.
+#define MIN_STARTING_RUN_LENGTH ((STARTING_RUN_POOL > 1) \
+        ? STARTING_RUN_POOL * \
+                RUN_LENGTH_IN(TRIPLE_BUFFER_SIZE - STARTING_RUN_RESERVE - POOL_OUT_SIZE) \
+        : RUN_LENGTH_IN(TRIPLE_BUFFER_SIZE - STARTING_RUN_RESERVE))
+
+/// @brief The instructions and DMA cycles spent by a single tasklet.
+struct work {
+    double instructions;
+    double dma;
+};
+
+/// @brief Associates the name of a coefficient with its place in the model.
+struct coefficient {
+    char const *name;
+    size_t offset;
+};
+
+#define COEFFICIENT(field) { #field, offsetof(struct cost_model, field) }
+
+static struct coefficient const coefficients[] = {
+    COEFFICIENT(issue_interval),
+    COEFFICIENT(dma_setup),
+    COEFFICIENT(dma_per_byte),
+    COEFFICIENT(compare_64bit),
+    COEFFICIENT(insertion_step),
+    COEFFICIENT(selection_step),
+    COEFFICIENT(quick_step),
+    COEFFICIENT(merge_wram_step),
+    COEFFICIENT(heap_step),
+    COEFFICIENT(merge_mram_step),
+    COEFFICIENT(copy_step),
+    COEFFICIENT(search_step),
+};
+
+void init_cost_model(struct cost_model *model) {
+    model->issue_interval = 11;
+    model->dma_setup = 77;
+    model->dma_per_byte = 0.5;
+    model->compare_64bit = 2;
+    model->insertion_step = 5;
+    model->selection_step = 4;
+    model->quick_step = 9;
+    model->merge_wram_step = 10;
+    model->heap_step = 14;
+    model->merge_mram_step = 13;
+    model->copy_step = 1;
+    model->search_step = 8;
+    model->starting_run_length = MIN_STARTING_RUN_LENGTH;
+}
+
+void read_cost_model(struct cost_model *model, char const *path) {
+    FILE *file = fopen(path, "r");
+    if (file == NULL) {
+        printf("‘%s’ cannot be opened!\n", path);
+        abort();
+    }
+    char line[256], name[128];
+    double value;
+    while (fgets(line, sizeof line, file) != NULL) {
+        char const *first = line;
+        while (isspace((unsigned char)*first)) first++;
+        if (*first == '\0' || *first == '#') continue;
+        if (sscanf(first, "%127s %lf", name, &value) != 2) {
+            printf("‘%s’ is no valid line of a calibration file!\n", first);
+            abort();
+        }
+        size_t const num_of_coefficients = sizeof coefficients / sizeof coefficients[0];
+        size_t c = 0;
+        while (c < num_of_coefficients && strcmp(coefficients[c].name, name) != 0)
+            c++;
+        if (c == num_of_coefficients) {
+            printf("‘%s’ is no known coefficient of the cost model!\n", name);
+            abort();
+        }
+        *(double *)((char *)model + coefficients[c].offset) = value;
+    }
+    fclose(file);
+}
+
+/**
+ * @brief Calculates the cycles of DMAs moving the given number of bytes in transfers of some size.
+ *
+ * @param model The coefficients of the model.
+ * @param bytes The number of bytes to move.
+ * @param transfer_size The maximum number of bytes moved by a single DMA.
+ *
+ * @return The cycles spent by the DMA engine.
+**/
+static double dma_cycles(struct cost_model const *model, double bytes, double transfer_size) {
+    return (bytes <= 0) ? 0 : ceil(bytes / transfer_size) * model->dma_setup +
+            bytes * model->dma_per_byte;
+}
+
+/**
+ * @brief Calculates the instructions per comparison-heavy step.
+ *
+ * @param model The coefficients of the model.
+ * @param step The instructions of the step when comparing 32-bit integers.
+ *
+ * @return The instructions for the current type.
+**/
+static double per_step(struct cost_model const *model, double step) {
+    return (DIV == 3) ? step + model->compare_64bit : step;
+}
+
+/**
+ * @brief Predicts the instructions of a WRAM sorting algorithm, identified by its name.
+ *
+ * @param model The coefficients of the model.
+ * @param mode The Id of the benchmark, which must be between 0 and 3.
+ * @param name The name of the sorting algorithm.
+ * @param n The number of elements to sort.
+ *
+ * @return The number of instructions or NaN if the algorithm is not modelled.
+**/
+static double wram_instructions(struct cost_model const *model, unsigned mode, char const *name,
+        double n) {
+    double const levels = (n > 1) ? log2(n) : 0;
+    switch (mode) {
+    case 0:  // InsertionSorts, ShellSorts with one custom step, BubbleSorts, and SelectionSort
+        if (isdigit((unsigned char)name[0]) && name[0] != '1') {
+            double const step = name[0] - '0';
+            return per_step(model, model->insertion_step) * (n * n / (4 * step) + n * step / 4);
+        } else if (strncmp(name, "Bubble", 6) == 0) {
+            return per_step(model, model->insertion_step) * n * n / 2;
+        } else if (strcmp(name, "Selection") == 0) {
+            return per_step(model, model->selection_step) * n * n / 2;
+        }
+        return per_step(model, model->insertion_step) * n * n / 4;
+    case 1:
+        return per_step(model, model->quick_step) * n * levels;
+    case 2:
+        return per_step(model, model->merge_wram_step) * n * levels;
+    case 3:
+        return per_step(model, model->heap_step) * n * levels;
+    }
+    return NAN;
+}
+
+/**
+ * @brief Predicts the work of a sequential MergeSort in MRAM.
+ *
+ * @param model The coefficients of the model.
+ * @param n The number of elements to sort.
+ * @param half_space Whether the first run of each pair is copied aside before merging.
+ * @param result Where to add the work.
+**/
+static void merge_mram_work(struct cost_model const *model, double n, bool half_space,
+        struct work *result) {
+    if (n <= 0) return;
+    double const bytes = n * sizeof(T);
+    /* Starting runs */
+    double const slice_length = model->starting_run_length / STARTING_RUN_POOL;
+    double const run_levels = log2(fmax(2, fmin(n, slice_length)));
+    double const run_step = (STABLE) ? model->merge_wram_step : model->quick_step;
+    result->instructions += per_step(model, run_step) * n * run_levels;
+    result->dma += 2 * dma_cycles(model, bytes, MAX_TRANSFER_SIZE_TRIPLE);
+    if (STARTING_RUN_POOL > 1)  // The pool merges its sorted slices through a tournament tree.
+        result->instructions += per_step(model, model->merge_wram_step) * n *
+                ceil(log2(STARTING_RUN_POOL));
+    /* Merge passes */
+    double const passes = ceil(log2(fmax(1, ceil(n / model->starting_run_length))));
+    double pass_dma = dma_cycles(model, bytes, SEQREAD_CACHE_SIZE) +
+            dma_cycles(model, bytes, MAX_TRANSFER_SIZE_CACHE);
+    double pass_instructions = per_step(model, model->merge_mram_step) * n;
+    if (half_space) {
+        pass_dma += 2 * dma_cycles(model, bytes / 2, MAX_TRANSFER_SIZE_TRIPLE);
+        pass_instructions += model->copy_step * n / 2;
+    }
+    result->instructions += passes * pass_instructions;
+    result->dma += passes * pass_dma;
+}
+
+/**
+ * @brief Calculates how often MergePar merges the run of a tasklet.
+ * Its merge tree splits the tasklets into two halves, the left one rounded up,
+ * until single tasklets remain.
+ *
+ * @param tasklet The Id of the tasklet.
+ * @param tasklets The number of active tasklets.
+ *
+ * @return The depth of the leaf of the tasklet.
+**/
+static unsigned leaf_depth(size_t const tasklet, unsigned const tasklets) {
+    unsigned depth = 0;
+    for (size_t lo = 0, hi = tasklets; hi - lo > 1; depth++) {
+        size_t const mid = lo + (hi - lo + 1) / 2;
+        if (tasklet < mid)
+            hi = mid;
+        else
+            lo = mid;
+    }
+    return depth;
+}
+
+/**
+ * @brief Combines the work of all tasklets into a predicted time.
+ *
+ * @param model The coefficients of the model.
+ * @param works The work of each tasklet.
+ *
+ * @return The predicted number of cycles.
+**/
+static double combine(struct cost_model const *model, struct work const works[NR_TASKLETS]) {
+    double slowest = 0, instructions = 0, dma = 0;
+    for (size_t t = 0; t < NR_TASKLETS; t++) {
+        slowest = fmax(slowest, works[t].instructions * model->issue_interval + works[t].dma);
+        instructions += works[t].instructions;
+        dma += works[t].dma;
+    }
+    return fmax(slowest, fmax(instructions, dma));
+}
+
+double predict_cycles(struct cost_model const *model, unsigned mode, char const *name,
+        size_t length, unsigned tasklets) {
+    struct work works[NR_TASKLETS] = { { 0, 0 } };
+    double const n = length;
+    if (mode <= 3) {
+        works[0].instructions = wram_instructions(model, mode, name, n);
+        return works[0].instructions * model->issue_interval;
+    } else if (mode > 7) {
+        return NAN;
+    }
+    /* All MRAM sorts first let each tasklet sort its part sequentially. */
+    size_t const part_length = DMA_ALIGNED(DIV_CEIL(length, tasklets) * sizeof(T)) / sizeof(T);
+    for (size_t t = 0; t < tasklets; t++) {
+        double const part = (t == tasklets - 1) ?
+                n - fmin(n, (double)t * part_length) :
+                fmin(part_length, n - fmin(n, (double)t * part_length));
+        merge_mram_work(model, part, mode == 4 || mode == 5, &works[t]);
+    }
+    if (mode != 7) return combine(model, works);
+    /* MergePar then merges the parts in ⌈log₂(`tasklets`)⌉ rounds, each tasklet an equal share.
+    Tasklets whose runs are merged less often idle in the first rounds.
+    Before a round, the tasklets partition their runs through binary searches one after another. */
+    double cycles = combine(model, works);
+    unsigned const height = leaf_depth(0, tasklets);
+    for (unsigned round = 1; round <= height; round++) {
+        size_t const node_size = ((1u << round) < tasklets) ? (1u << round) : tasklets;
+        double const searches = round * ceil(log2(fmax(2, part_length * node_size)));
+        for (size_t t = 0; t < tasklets; t++) {
+            double const share = (leaf_depth(t, tasklets) + round > height) ? n / tasklets : 0;
+            works[t].instructions = per_step(model, model->merge_mram_step) * share;
+            works[t].dma = dma_cycles(model, share * sizeof(T), SEQREAD_CACHE_SIZE) +
+                    dma_cycles(model, share * sizeof(T), MAX_TRANSFER_SIZE_CACHE);
+        }
+        works[0].instructions += searches * per_step(model, model->search_step);
+        works[0].dma += searches * dma_cycles(model, DMA_ALIGNMENT, DMA_ALIGNMENT);
+        cycles += combine(model, works);
+    }
+    return cycles;
+}
+
+unsigned fastest_tasklets(struct cost_model const *model, unsigned mode, char const *name,
+        size_t length) {
+    unsigned best = NR_TASKLETS;
+    double best_cycles = predict_cycles(model, mode, name, length, NR_TASKLETS);
+    for (unsigned tasklets = NR_TASKLETS - 1; tasklets >= 1; tasklets--) {
+        double const cycles = predict_cycles(model, mode, name, length, tasklets);
+        if (cycles < 0.99 * best_cycles) {  // Never true for NaN.
+            best = tasklets;
+            best_cycles = cycles;
+        }
+    }
+    return best;
+}
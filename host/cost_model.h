@@ -0,0 +1,98 @@
+/**
+ * @file
+ * @brief An analytical model of the runtimes of the sorting algorithms on a DPU.
+ *
+ * The model counts the instructions and the DMAs an algorithm performs for a given input length
+ * and configuration (`TYPE`, `NR_TASKLETS`, `CACHE_SIZE`, `SEQREAD_CACHE_SIZE`, `STABLE`),
+ * including the number of merge passes an MRAM MergeSort needs.
+ * These counts are weighted by coefficients which can be calibrated through microbenchmarks.
+ * A tasklet issues at most one instruction every `issue_interval` cycles,
+ * the pipeline at most one instruction per cycle, and the DMA engine serves one DMA at a time.
+ * The predicted time is the largest of these three bounds.
+**/
+
+#ifndef _COST_MODEL_H_
+#define _COST_MODEL_H_
+
+#include <stddef.h>
+
+#include "communication.h"
+
+/// @brief The coefficients of the cost model. All instruction counts are per operation named.
+struct cost_model {
+    /// @brief The number of cycles between two instructions of the same tasklet.
+    double issue_interval;
+    /// @brief The fixed cycles of a DMA between MRAM and WRAM.
+    double dma_setup;
+    /// @brief The cycles per byte of a DMA between MRAM and WRAM.
+    double dma_per_byte;
+    /// @brief The additional instructions of a comparison of 64-bit integers.
+    double compare_64bit;
+    /// @brief The instructions per shift of an InsertionSort or BubbleSort.
+    double insertion_step;
+    /// @brief The instructions per comparison of a SelectionSort.
+    double selection_step;
+    /// @brief The instructions per element and recursion level of a QuickSort.
+    double quick_step;
+    /// @brief The instructions per element and pass of a MergeSort in WRAM.
+    double merge_wram_step;
+    /// @brief The instructions per element and tree level of a HeapSort.
+    double heap_step;
+    /// @brief The instructions per element and pass of a merge in MRAM.
+    double merge_mram_step;
+    /// @brief The instructions per element of copying a run in MRAM.
+    double copy_step;
+    /// @brief The instructions per step of a binary search in MRAM.
+    double search_step;
+    /// @brief The number of items in the starting runs of the MRAM MergeSorts.
+    /// No coefficient but a property of the DPU binary, which reports it in `dpu_results`.
+    double starting_run_length;
+};
+
+/**
+ * @brief Sets the coefficients to default values, which were estimated from measured runs.
+ * The length of the starting runs is set to its lower bound, an arena the size of a triple buffer.
+ *
+ * @param model The coefficients to set.
+**/
+void init_cost_model(struct cost_model *model);
+
+/**
+ * @brief Overrides coefficients with the values of a calibration file.
+ * Each line consists of the name of a coefficient and its value, separated by whitespace.
+ * Empty lines and lines starting with `#` are ignored. Unknown names cause an abort.
+ *
+ * @param model The coefficients to override.
+ * @param path The path to the calibration file.
+**/
+void read_cost_model(struct cost_model *model, char const *path);
+
+/**
+ * @brief Predicts how many cycles a sorting algorithm of some benchmark needs.
+ *
+ * @param model The coefficients of the model.
+ * @param mode The Id of the benchmark.
+ * @param name The name of the sorting algorithm as reported by the DPU.
+ * @param length The number of elements to sort.
+ * @param tasklets How many tasklets sort, from 1 to `NR_TASKLETS`. Ignored by WRAM sorts.
+ *
+ * @return The predicted number of cycles or NaN if the algorithm is not modelled.
+**/
+double predict_cycles(struct cost_model const *model, unsigned mode, char const *name,
+        size_t length, unsigned tasklets);
+
+/**
+ * @brief Picks the number of active tasklets for which the model predicts the least cycles.
+ * Fewer tasklets only win if they save at least 1 %, e.g. since MergePar needs fewer rounds.
+ *
+ * @param model The coefficients of the model.
+ * @param mode The Id of the benchmark.
+ * @param name The name of the sorting algorithm as reported by the DPU.
+ * @param length The number of elements to sort.
+ *
+ * @return The number of tasklets, which is `NR_TASKLETS` if the algorithm is not modelled.
+**/
+unsigned fastest_tasklets(struct cost_model const *model, unsigned mode, char const *name,
+        size_t length);
+
+#endif  // _COST_MODEL_H_
@@ -0,0 +1,274 @@
+#define _POSIX_C_SOURCE 200112L
+
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "cpu_sorts.h"
+
+/// @brief How many elements a thread should sort at least. Fewer threads are spawned otherwise.
+#define MIN_ELEMS_PER_THREAD (4096)
+/// @brief The maximum number of threads spawned by a parallel sort.
+#define MAX_THREADS (256)
+/// @brief How many bits are sorted at once by the RadixSort.
+#define RADIX_BITS (8)
+/// @brief The number of buckets of the RadixSort.
+#define RADIX_BUCKETS (1 << RADIX_BITS)
+
+/// @brief The data shared by all threads of a parallel sort.
+struct shared_data {
+    /// @brief The array to sort.
+    T *array;
+    /// @brief An auxiliary array of the same length.
+    T *aux;
+    /// @brief The number of elements to sort.
+    size_t length;
+    /// @brief The number of threads.
+    size_t nr_threads;
+    /// @brief Used for synchronising the threads between rounds.
+    pthread_barrier_t barrier;
+    /// @brief The bucket sizes of each thread, needed by the RadixSort.
+    size_t (*histograms)[RADIX_BUCKETS];
+};
+
+/// @brief The arguments passed to each thread of a parallel sort.
+struct thread_data {
+    /// @brief The data shared by all threads.
+    struct shared_data *shared;
+    /// @brief The Id of the thread.
+    size_t id;
+};
+
+/**
+ * @brief Compares two elements. Needed by `qsort`.
+**/
+static int compare_elements(void const *a, void const *b) {
+    T const x = *(T const *)a, y = *(T const *)b;
+    return (x > y) - (x < y);
+}
+
+/**
+ * @brief Sorts an array using the `qsort` of the C standard library.
+ *
+ * @param array The array to sort.
+ * @param aux Unused.
+ * @param length The length of the array.
+**/
+static void qsort_cpu(T array[], T aux[], size_t const length) {
+    (void)aux;
+    qsort(array, length, sizeof(T), compare_elements);
+}
+
+/**
+ * @brief Computes how many threads to spawn for sorting an array of a given length.
+ *
+ * @param length The number of elements to sort.
+ *
+ * @return The number of threads.
+**/
+static size_t get_nr_threads(size_t const length) {
+    long const cores = sysconf(_SC_NPROCESSORS_ONLN);
+    size_t threads = (cores > 0) ? (size_t)cores : 1;
+    if (threads > MAX_THREADS)
+        threads = MAX_THREADS;
+    if (threads > DIV_CEIL(length, MIN_ELEMS_PER_THREAD))
+        threads = DIV_CEIL(length, MIN_ELEMS_PER_THREAD);
+    return threads;
+}
+
+/**
+ * @brief Spawns threads which all execute the same function, then waits for them to finish.
+ * The calling thread takes on the role of the thread with the Id 0.
+ *
+ * @param shared The data shared by all threads. Its number of threads must be set.
+ * @param routine The function to execute.
+**/
+static void run_in_parallel(struct shared_data *shared, void *(*routine)(void *)) {
+    pthread_t threads[MAX_THREADS];
+    struct thread_data args[MAX_THREADS];
+    pthread_barrier_init(&shared->barrier, NULL, shared->nr_threads);
+    for (size_t t = 0; t < shared->nr_threads; t++)
+        args[t] = (struct thread_data){ shared, t };
+    for (size_t t = 1; t < shared->nr_threads; t++)
+        pthread_create(&threads[t], NULL, routine, &args[t]);
+    routine(&args[0]);
+    for (size_t t = 1; t < shared->nr_threads; t++)
+        pthread_join(threads[t], NULL);
+    pthread_barrier_destroy(&shared->barrier);
+}
+
+/**
+ * @brief One thread of the parallel LSD RadixSort.
+ * Each thread counts the digits of its part, computes the positions of its elements
+ * from the counts of all threads, and scatters them into the other array.
+ *
+ * @param arg The `thread_data` of the thread.
+ *
+ * @return Nothing.
+**/
+static void *radix_sort_thread(void *arg) {
+    struct thread_data const *me = arg;
+    struct shared_data *shared = me->shared;
+    size_t const part = DIV_CEIL(shared->length, shared->nr_threads);
+    size_t const from = (me->id * part < shared->length) ? me->id * part : shared->length;
+    size_t const to = (from + part < shared->length) ? from + part : shared->length;
+    size_t *histogram = shared->histograms[me->id];
+    T *in = shared->array, *out = shared->aux;
+
+    for (size_t shift = 0; shift < sizeof(T) * 8; shift += RADIX_BITS) {
+        memset(histogram, 0, sizeof(size_t[RADIX_BUCKETS]));
+        for (size_t i = from; i < to; i++)
+            histogram[(in[i] >> shift) & (RADIX_BUCKETS - 1)]++;
+        pthread_barrier_wait(&shared->barrier);
+
+        size_t positions[RADIX_BUCKETS], position = 0;
+        for (size_t digit = 0; digit < RADIX_BUCKETS; digit++) {
+            for (size_t t = 0; t < shared->nr_threads; t++) {
+                if (t == me->id)
+                    positions[digit] = position;
+                position += shared->histograms[t][digit];
+            }
+        }
+        pthread_barrier_wait(&shared->barrier);  // Histograms are reset in the next round.
+
+        for (size_t i = from; i < to; i++)
+            out[positions[(in[i] >> shift) & (RADIX_BUCKETS - 1)]++] = in[i];
+        pthread_barrier_wait(&shared->barrier);
+        T *temp = in;
+        in = out;
+        out = temp;
+    }
+    return NULL;
+}
+
+/**
+ * @brief A parallel LSD RadixSort sorting `RADIX_BITS` bits per round.
+ * Since the number of rounds is even, the sorted data end up in the original array.
+ *
+ * @param array The array to sort.
+ * @param aux An auxiliary array of the same length.
+ * @param length The length of the array.
+**/
+static void radix_sort_cpu(T array[], T aux[], size_t const length) {
+    struct shared_data shared = { .array = array, .aux = aux, .length = length };
+    shared.nr_threads = get_nr_threads(length);
+    shared.histograms = malloc(sizeof(size_t[shared.nr_threads][RADIX_BUCKETS]));
+    run_in_parallel(&shared, radix_sort_thread);
+    free(shared.histograms);
+}
+
+/**
+ * @brief Merges two adjacent sorted runs.
+ *
+ * @param in The array holding both runs.
+ * @param out Where to write the merged run to.
+ * @param from The first index of the first run.
+ * @param middle The first index of the second run.
+ * @param to The index after the last element of the second run.
+**/
+static void merge_runs(T const in[], T out[], size_t const from, size_t const middle,
+        size_t const to) {
+    size_t i = from, j = middle, k = from;
+    while (i < middle && j < to)
+        out[k++] = (in[j] < in[i]) ? in[j++] : in[i++];
+    memcpy(&out[k], &in[i], sizeof(T[middle - i]));
+    k += middle - i;
+    memcpy(&out[k], &in[j], sizeof(T[to - j]));
+}
+
+/**
+ * @brief A sequential bottom-up MergeSort.
+ * The sorted data end up in `array`.
+ *
+ * @param array The array to sort.
+ * @param aux An auxiliary array of the same length.
+ * @param from The first index to sort.
+ * @param to The index after the last element to sort.
+**/
+static void merge_sort_sequential(T array[], T aux[], size_t const from, size_t const to) {
+    T *in = array, *out = aux;
+    for (size_t run = 1; run < to - from; run *= 2) {
+        for (size_t i = from; i < to; i += 2 * run) {
+            size_t const middle = (i + run < to) ? i + run : to;
+            size_t const end = (middle + run < to) ? middle + run : to;
+            merge_runs(in, out, i, middle, end);
+        }
+        T *temp = in;
+        in = out;
+        out = temp;
+    }
+    if (in != array)
+        memcpy(&array[from], &in[from], sizeof(T[to - from]));
+}
+
+/**
+ * @brief One thread of the parallel MergeSort.
+ * Each thread sorts its part sequentially.
+ * Afterwards, the sorted parts are merged pairwise in a tree.
+ *
+ * @param arg The `thread_data` of the thread.
+ *
+ * @return Nothing.
+**/
+static void *merge_sort_thread(void *arg) {
+    struct thread_data const *me = arg;
+    struct shared_data *shared = me->shared;
+    size_t const part = DIV_CEIL(shared->length, shared->nr_threads);
+#define BORDER(t) (((t) * part < shared->length) ? (t) * part : shared->length)
+
+    merge_sort_sequential(shared->array, shared->aux, BORDER(me->id), BORDER(me->id + 1));
+    for (size_t step = 1; step < shared->nr_threads; step *= 2) {
+        pthread_barrier_wait(&shared->barrier);
+        if (me->id % (2 * step) == 0 && me->id + step < shared->nr_threads) {
+            size_t const from = BORDER(me->id), middle = BORDER(me->id + step);
+            size_t const to = BORDER(me->id + 2 * step);
+            merge_runs(shared->array, shared->aux, from, middle, to);
+            memcpy(&shared->array[from], &shared->aux[from], sizeof(T[to - from]));
+        }
+    }
+#undef BORDER
+    return NULL;
+}
+
+/**
+ * @brief A parallel MergeSort.
+ *
+ * @param array The array to sort.
+ * @param aux An auxiliary array of the same length.
+ * @param length The length of the array.
+**/
+static void merge_sort_cpu(T array[], T aux[], size_t const length) {
+    struct shared_data shared = { .array = array, .aux = aux, .length = length };
+    shared.nr_threads = get_nr_threads(length);
+    run_in_parallel(&shared, merge_sort_thread);
+}
+
+struct cpu_algo const cpu_algos[] = {
+    { "CPU-qsort", qsort_cpu },
+    { "CPU-Radix", radix_sort_cpu },
+    { "CPU-Merge", merge_sort_cpu },
+};
+size_t const num_of_cpu_algos = sizeof cpu_algos / sizeof cpu_algos[0];
+
+dpu_time time_cpu_sort(sort_algo_cpu *algo, T const input[], T array[], T aux[],
+        size_t const length) {
+    struct timespec start, end;
+    memcpy(array, input, sizeof(T[length]));
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    algo(array, aux, length);
+    clock_gettime(CLOCK_MONOTONIC, &end);
+#if (CHECK_SANITY)
+    for (size_t i = 1; i < length; i++) {
+        if (array[i - 1] > array[i]) {
+            printf(ANSI_COLOR_RED "CPU sort failed at index %zu!\n" ANSI_COLOR_RESET, i);
+            abort();
+        }
+    }
+#endif
+    uint64_t const ns = (end.tv_sec - start.tv_sec) * 1000000000ULL + end.tv_nsec - start.tv_nsec;
+    return ns * DPU_FREQUENCY / 1000;
+}
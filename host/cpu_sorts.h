@@ -0,0 +1,51 @@
+/**
+ * @file
+ * @brief Sorting the benchmark inputs on the host CPU for comparison with the DPU.
+**/
+
+#ifndef _CPU_SORTS_H_
+#define _CPU_SORTS_H_
+
+#include <stddef.h>
+
+#include "common.h"
+#include "communication.h"
+
+#ifndef DPU_FREQUENCY
+/// @brief The clock frequency of a DPU in MHz.
+/// Used to convert the runtimes on the CPU into DPU cycles.
+#define DPU_FREQUENCY (350)
+#endif
+
+/// @brief Every CPU sorting function must adher to this pattern.
+/// The auxiliary array has the same length as the array to sort.
+typedef void sort_algo_cpu(T array[], T aux[], size_t const length);
+
+/// @brief A sorting algorithm running on the CPU and its name.
+struct cpu_algo {
+    /// @brief The name of the algorithm to print in the console.
+    char const *name;
+    /// @brief The sorting function.
+    sort_algo_cpu *fct;
+};
+
+/// @brief All sorting algorithms run on the CPU.
+extern struct cpu_algo const cpu_algos[];
+/// @brief The number of sorting algorithms run on the CPU.
+extern size_t const num_of_cpu_algos;
+
+/**
+ * @brief Sorts a copy of some input on the CPU and measures the time needed.
+ *
+ * @param algo The sorting algorithm to use.
+ * @param input The input to sort. Stays unchanged.
+ * @param array An array of at least `length` elements where to copy the input to.
+ * @param aux An auxiliary array of at least `length` elements.
+ * @param length The number of elements to sort.
+ *
+ * @return The time needed in DPU cycles, assuming a frequency of `DPU_FREQUENCY` MHz.
+**/
+dpu_time time_cpu_sort(sort_algo_cpu *algo, T const input[], T array[], T aux[],
+        size_t const length);
+
+#endif  // _CPU_SORTS_H_
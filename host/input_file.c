@@ -0,0 +1,65 @@
+#define _POSIX_C_SOURCE 200112L
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "input_file.h"
+
+void open_input_file(struct input_file *file, char const *path, size_t const offset,
+        size_t const length) {
+    int const fd = open(path, O_RDONLY);
+    struct stat info;
+    if (fd < 0 || fstat(fd, &info) != 0) {
+        printf("‘%s’ cannot be opened!\n", path);
+        abort();
+    }
+    size_t const num_of_keys = info.st_size / sizeof(T);
+    if (offset >= num_of_keys || (length != 0 && offset + length > num_of_keys)) {
+        printf("‘%s’ holds only %zu keys of type %s!\n", path, num_of_keys, TYPE_NAME);
+        abort();
+    }
+    file->mapping_size = info.st_size;
+    file->mapping = mmap(NULL, file->mapping_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (file->mapping == MAP_FAILED) {
+        printf("‘%s’ cannot be mapped into memory!\n", path);
+        abort();
+    }
+    posix_madvise(file->mapping, file->mapping_size, POSIX_MADV_SEQUENTIAL);
+    file->keys = (T const *)file->mapping + offset;
+    file->length = (length != 0) ? length : num_of_keys - offset;
+    file->next = 0;
+}
+
+void close_input_file(struct input_file *file) {
+    munmap(file->mapping, file->mapping_size);
+}
+
+T const *read_input_file(struct input_file *file, T buffer[], size_t const length,
+        size_t const stride, uint32_t const reps) {
+    if (length > file->length) {
+        printf("The input length %zu is too big! The file holds only %zu keys.\n",
+                length, file->length);
+        abort();
+    }
+    if (file->next + length > file->length)
+        file->next = 0;
+    /* Stream directly from the mapping if no padding between the inputs is needed. */
+    if (stride == length && file->next + length * reps <= file->length) {
+        T const *inputs = &file->keys[file->next];
+        file->next += length * reps;
+        return inputs;
+    }
+    for (uint32_t i = 0; i < reps; i++) {
+        if (file->next + length > file->length)
+            file->next = 0;
+        memcpy(&buffer[i * stride], &file->keys[file->next], sizeof(T[length]));
+        file->next += length;
+    }
+    return buffer;
+}
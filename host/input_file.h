@@ -0,0 +1,67 @@
+/**
+ * @file
+ * @brief Reading inputs from raw binary files of elements of type `T`.
+**/
+
+#ifndef _INPUT_FILE_H_
+#define _INPUT_FILE_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "common.h"
+
+/// @brief A memory-mapped file of keys from which consecutive inputs are taken.
+struct input_file {
+    /// @brief The start of the memory mapping.
+    void *mapping;
+    /// @brief The size of the memory mapping in bytes.
+    size_t mapping_size;
+    /// @brief The first key to use.
+    T const *keys;
+    /// @brief The number of keys to use.
+    size_t length;
+    /// @brief The index of the key at which the next input starts.
+    size_t next;
+};
+
+/**
+ * @brief Maps a file of raw keys into memory.
+ * Aborts if the file cannot be opened or does not contain enough keys.
+ * @sa close_input_file
+ *
+ * @param file Where to store the information about the mapping.
+ * @param path The path to the file.
+ * @param offset The number of keys to skip at the start of the file.
+ * @param length The number of keys to use. If zero, all keys after the offset are used.
+**/
+void open_input_file(struct input_file *file, char const *path, size_t const offset,
+        size_t const length);
+
+/**
+ * @brief Unmaps a file of raw keys.
+ * @sa open_input_file
+ *
+ * @param file The file to unmap.
+**/
+void close_input_file(struct input_file *file);
+
+/**
+ * @brief Takes the next `reps` inputs of length `length` from the file.
+ * If the end of the file is reached, the reading begins anew at the start.
+ * If the inputs lie contiguously in the file and need no padding,
+ * a pointer into the mapping is returned so that no copy is made.
+ * Otherwise, the inputs are copied into the buffer.
+ *
+ * @param file The file to read from.
+ * @param buffer Where to copy the inputs to if needed.
+ * @param length The number of keys per input.
+ * @param stride The distance between the starts of two consecutive inputs in the buffer.
+ * @param reps The number of inputs to take.
+ *
+ * @return The first key of the first input.
+**/
+T const *read_input_file(struct input_file *file, T buffer[], size_t const length,
+        size_t const stride, uint32_t const reps);
+
+#endif  // _INPUT_FILE_H_
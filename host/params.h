@@ -8,6 +8,7 @@
 
 #include <assert.h>
 #include <getopt.h>
+#include <stdbool.h>
 #include <stdlib.h>
 #include <string.h>
 
@@ -18,8 +19,19 @@ struct Params {
     char *lengths;  // number of elements to sort
     uint32_t mode;  // benchmark: ID (0=no benchmark)
     uint32_t n_reps;  // benchmark: how often to repeat measurements
+    uint32_t n_warmups;  // benchmark: how many unmeasured launches precede the measurements
+    bool verify;  // whether to check the sorted data on the host
+    bool simulator;  // whether to run on the functional simulator instead of actual DPUs
+    bool cpu_baselines;  // benchmark: whether to sort the same inputs on the CPU for comparison
+    bool model;  // benchmark: whether to print the cycles predicted by the cost model
+    char *calibration;  // file of coefficients of the cost model (NULL=defaults)
+    uint32_t transfer_dpus;  // benchmark: up to how many DPUs to measure transfers with (0=none)
+    uint32_t active_tasklets;  // how many tasklets MRAM sorts use (0=fastest predicted per length)
     uint32_t dist_type;  // distribution to draw from
     T dist_param;  // parameter to pass to distribution
+    char *file;  // file of raw keys to read the inputs from instead of drawing them
+    size_t file_offset;  // number of keys to skip at the start of the file
+    size_t file_length;  // number of keys of the file to use (0=all after the offset)
 };
 
 static void usage(void) {
@@ -28,10 +40,21 @@ static void usage(void) {
         "\n"
         "\nOptions:"
         "\n    -h          help"
-        "\n    -n <uint>   input length [default: 512]"
+        "\n    -n <uint>   input length [default: 512, or the number of keys used from the file]"
         "\n    -t <uint>   type of the distribution to draw from (set to -1 to show list of all types) [default: uniform]"
         "\n    -p <uint>   parameter to pass to distribution (set to -1 to show list of all meanings)"
+        "\n    -f <path>   file of raw keys of type `T` to read the inputs from instead of drawing them"
+        "\n    -o <uint>   number of keys to skip at the start of the file [default: 0]"
+        "\n    -l <uint>   number of keys of the file to use [default: all after the offset]"
         "\n    -r <uint>   number of timed repetition iterations [default: 3]"
+        "\n    -w <uint>   number of untimed warm-up launches per length and algorithm [default: 1]"
+        "\n    -c <0|1>    sort the inputs on the CPU as well to compute speedups [default: 1]"
+        "\n    -v          verify the sorted data on the host"
+        "\n    -s          run on the functional simulator instead of actual DPUs"
+        "\n    -m          print the cycles predicted by the cost model and their relative error"
+        "\n    -k <path>   file of calibrated coefficients of the cost model (implies -m)"
+        "\n    -a <uint>   number of tasklets which MRAM sorts use [default: fastest predicted by the cost model]"
+        "\n    -x <uint>   measure host-DPU transfers on 1, 2, 4, … up to this many DPUs first [default: 0]"
         "\n    -b <int>    Id of the benchmark to run (set to -1 to show list of all Ids) [default: 0]"
         "\n"
     );
@@ -47,6 +70,13 @@ static void show_distributions(void) {
         "\n     4   Uniform"
         "\n     5   Zipf"
         "\n     6   Normal"
+        "\n     7   Sawtooth"
+        "\n     8   Organ Pipe"
+        "\n     9   Sorted Runs"
+        "\n    10   Few Unique"
+        "\n    11   Shuffled Blocks"
+        "\n    12   Median-of-3 Killer"
+        "\n    13   Merge Killer"
         "\n"
     );
 }
@@ -61,6 +91,13 @@ static void show_param_meanings(void) {
         "\n     Uniform:          upper bound (exclusive) of range to draw from [default: maximum]"
         "\n     Zipf:             /"
         "\n     Normal:           standard deviation [default: 𝘯/8]"
+        "\n     Sawtooth:         length of each tooth [default: √𝘯]"
+        "\n     Organ Pipe:       /"
+        "\n     Sorted Runs:      number of runs [default: √𝘯]"
+        "\n     Few Unique:       number of distinct values [default: 16]"
+        "\n     Shuffled Blocks:  length of each block [default: √𝘯]"
+        "\n     Median-of-3 Killer: /"
+        "\n     Merge Killer:     length of each part [default: part length of MergePar]"
         "\n"
         "\nNon-zero default values internally equal zero as well."
         "\n"
@@ -78,26 +115,60 @@ static void show_modes(void) {
         "\n     5   MergeSort (MRAM, half-space, custom reader)"
         "\n     6   MergeSort (MRAM, full-space, straight reader)"
         "\n     7   MergeSort (parallel) [default]"
+        "\n     8   DMAs of different sizes and alignments, and the call overhead (MRAM)"
         "\n"
     );
 }
 
 struct Params input_params(int argc, char **argv) {
     struct Params p;
-    p.lengths = "512";
+    p.lengths = NULL;
     p.dist_type = 4;
     p.dist_param = 0;
     p.n_reps = 1;
+    p.n_warmups = 1;
+    p.cpu_baselines = true;
+    p.verify = false;
+    p.simulator = false;
+    p.model = false;
+    p.calibration = NULL;
+    p.transfer_dpus = 0;
+    p.active_tasklets = 0;
     p.mode = 7;
+    p.file = NULL;
+    p.file_offset = 0;
+    p.file_length = 0;
 
     int opt;
-    while ((opt = getopt(argc, argv, "hn:t:p:w:r:b:")) >= 0) {
-        double value = atof(optarg);
+    while ((opt = getopt(argc, argv, "hvsmn:t:p:f:o:l:w:r:c:b:k:x:a:")) >= 0) {
+        double value = (optarg != NULL) ? atof(optarg) : 0;
         switch(opt) {
         case 'h':
             usage();
             exit(0);
             break;
+        case 'v':
+            p.verify = true;
+            break;
+        case 's':
+            p.simulator = true;
+            break;
+        case 'm':
+            p.model = true;
+            break;
+        case 'k':
+            p.model = true;
+            p.calibration = optarg;
+            break;
+        case 'x':
+            assert(value >= 0 && "Number of DPUs must be non-negative!");
+            p.transfer_dpus = value;
+            break;
+        case 'a':
+            // Big values are caught in app.c.
+            assert(value > 0 && "Number of active tasklets must be positive!");
+            p.active_tasklets = value;
+            break;
         case 'n':
             p.lengths = optarg;
             break;
@@ -120,10 +191,28 @@ struct Params input_params(int argc, char **argv) {
                 p.dist_param = value;
                 break;
             }
+        case 'f':
+            p.file = optarg;
+            break;
+        case 'o':
+            assert(value >= 0 && "Offset into the file must be non-negative!");
+            p.file_offset = value;
+            break;
+        case 'l':
+            assert(value >= 0 && "Number of keys to use from the file must be non-negative!");
+            p.file_length = value;
+            break;
         case 'r':
             assert(value > 0 && "Number of iterations must be positive!");
             p.n_reps = value;
             break;
+        case 'w':
+            assert(value >= 0 && "Number of warm-up launches must be non-negative!");
+            p.n_warmups = value;
+            break;
+        case 'c':
+            p.cpu_baselines = (value != 0);
+            break;
         case 'b':
             if (strcmp(optarg, "-1") == 0) {
                 show_modes();
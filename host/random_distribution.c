@@ -152,6 +152,147 @@ static void generate_normal_distribution(T array[], size_t const length, T std_d
     }
 }
 
+/**
+ * @brief Generates teeth of ascending numbers, each starting from zero.
+ * 
+ * @param array Where the numbers are to be stored.
+ * @param length How many numbers are to be generated.
+ * @param tooth_length The length of each tooth. If zero, teeth of length √n are made.
+**/
+static void generate_sawtooth_distribution(T array[], size_t const length, size_t tooth_length) {
+    tooth_length = (tooth_length) ? : ((size_t)sqrt(length) ? : 1);
+    for (size_t i = 0; i < length; i++) {
+        array[i] = i % tooth_length;
+    }
+}
+
+/**
+ * @brief Generates ascending numbers in the first half and descending numbers in the second one.
+ * 
+ * @param array Where the numbers are to be stored.
+ * @param length How many numbers are to be generated.
+**/
+static void generate_organ_pipe_distribution(T array[], size_t const length) {
+    for (size_t i = 0; i < length; i++) {
+        array[i] = (i < length - 1 - i) ? i : length - 1 - i;
+    }
+}
+
+/**
+ * @brief Compares two elements for `qsort`.
+ * 
+ * @return A negative number if the first element is less, a positive one if it is greater,
+ * and zero if both are equal.
+**/
+static int cmp(void const *a, void const *b) {
+    T const x = *(T const *)a, y = *(T const *)b;
+    return (x > y) - (x < y);
+}
+
+/**
+ * @brief Uniformly draws numbers, then sorts consecutive runs of them.
+ * 
+ * @param array Where the numbers are to be stored.
+ * @param length How many numbers are to be generated.
+ * @param runs The number of sorted runs. If zero, √n runs are made.
+**/
+static void generate_sorted_runs_distribution(T array[], size_t const length, size_t runs) {
+    runs = (runs) ? : ((size_t)sqrt(length) ? : 1);
+    size_t const run_length = DIV_CEIL(length, runs);
+    generate_uniform_distribution(array, length, 0);
+    for (size_t i = 0; i < length; i += run_length) {
+        qsort(&array[i], (i + run_length < length) ? run_length : length - i, sizeof(T), cmp);
+    }
+}
+
+/**
+ * @brief Uniformly draws from a small number of values which are spread over the range of `T`.
+ * 
+ * @param array Where the numbers are to be stored.
+ * @param length How many numbers are to be generated.
+ * @param values The number of distinct values. If zero, 16 values are used.
+**/
+static void generate_few_unique_distribution(T array[], size_t const length, T values) {
+    values = (values) ? : 16;
+    T const gap = T_MAX / values;
+    for (size_t i = 0; i < length; i++) {
+        array[i] = ((values > 1) ? round_reject(values - 1) : 0) * gap;
+    }
+}
+
+/**
+ * @brief Generates a range of ascending numbers, then shuffles blocks of them.
+ * The order within each block is kept.
+ * 
+ * @param array Where the numbers are to be stored.
+ * @param length How many numbers are to be generated.
+ * @param block_length The length of each block. If zero, blocks of length √n are made.
+**/
+static void generate_shuffled_blocks_distribution(T array[], size_t const length,
+        size_t block_length) {
+    block_length = (block_length) ? : ((size_t)sqrt(length) ? : 1);
+    size_t const blocks = DIV_CEIL(length, block_length);
+    size_t *order = malloc(sizeof(size_t[blocks]));
+    for (size_t b = 0; b < blocks; b++) {
+        order[b] = b;
+    }
+    for (size_t b = blocks - 1; b > 0; b--) {  // Fisher–Yates shuffle
+        size_t const other = round_reject(b), temp = order[b];
+        order[b] = order[other];
+        order[other] = temp;
+    }
+    size_t i = 0;
+    for (size_t b = 0; b < blocks; b++) {
+        size_t const first = order[b] * block_length;
+        size_t const last = (first + block_length < length) ? first + block_length : length;
+        for (size_t value = first; value < last; value++) {
+            array[i++] = value;
+        }
+    }
+    free(order);
+}
+
+/**
+ * @brief Generates the median-of-3 killer sequence by Musser (‘Introspective Sorting and
+ * Selection Algorithms’, 1997), which leads QuickSorts choosing the median of the leftmost,
+ * middle and rightmost element as pivot to partition off only two elements at a time.
+ * For an odd length, the greatest number is appended.
+ * 
+ * @param array Where the numbers are to be stored.
+ * @param length How many numbers are to be generated.
+**/
+static void generate_median_killer_distribution(T array[], size_t const length) {
+    size_t const k = length / 2;
+    for (size_t i = 0; i < k; i++) {
+        array[i] = (i & 1) ? k + i : i + 1;
+        array[k + i] = 2 * (i + 1);
+    }
+    if (length & 1) {
+        array[length - 1] = length;
+    }
+}
+
+/**
+ * @brief Uniformly draws numbers for each part from its own range such that all numbers of a part
+ * are greater than those of its predecessors.
+ * This way, every merge of `merge_par` finds all elements of the shorter run on one side of the
+ * pivot, so each split hands three quarters of the work to one tasklet.
+ * 
+ * @param array Where the numbers are to be stored.
+ * @param length How many numbers are to be generated.
+ * @param part_length The length of each part.
+ * If zero, the length of the parts sorted by the tasklets of `merge_par` is used.
+**/
+static void generate_merge_killer_distribution(T array[], size_t const length,
+        size_t part_length) {
+    part_length = (part_length) ? :
+            ((DMA_ALIGNED(DIV_CEIL(length, NR_TASKLETS) * sizeof(T)) / sizeof(T)) ? : 1);
+    for (size_t i = 0; i < length; i++) {
+        T const shift = (part_length > 1) ? round_reject(part_length - 1) : 0;
+        array[i] = (i / part_length) * part_length + shift;
+    }
+}
+
 void generate_input_distribution(T array[], size_t const length, enum dist const type,
         T const param) {
     switch (type) {
@@ -162,6 +303,13 @@ void generate_input_distribution(T array[], size_t const length, enum dist const
     case uniform: generate_uniform_distribution(array, length, param); break;
     case zipf: generate_zipf_distribution(array, length); break;
     case normal: generate_normal_distribution(array, length, param); break;
+    case sawtooth: generate_sawtooth_distribution(array, length, param); break;
+    case organpipe: generate_organ_pipe_distribution(array, length); break;
+    case sortedruns: generate_sorted_runs_distribution(array, length, param); break;
+    case fewunique: generate_few_unique_distribution(array, length, param); break;
+    case shuffledblocks: generate_shuffled_blocks_distribution(array, length, param); break;
+    case medkiller: generate_median_killer_distribution(array, length); break;
+    case mergekiller: generate_merge_killer_distribution(array, length, param); break;
     default: break;
     }
 }
@@ -9,8 +9,7 @@
 #include <stddef.h>
 
 #include "common.h"
-
-enum dist { sorted, reverse, almost, zeroone, uniform, zipf, normal, nr_of_dists };
+#include "communication.h"
 
 /**
  * @brief Generates a sequence of numbers according to some random distribution.
@@ -38,6 +37,13 @@ static inline char *get_dist_name(enum dist type) {
     case uniform: return "uniform";
     case zipf: return "Zipf";
     case normal: return "normal";
+    case sawtooth: return "sawtooth";
+    case organpipe: return "organ pipe";
+    case sortedruns: return "sorted runs";
+    case fewunique: return "few unique";
+    case shuffledblocks: return "shuffled blocks";
+    case medkiller: return "median-of-3 killer";
+    case mergekiller: return "merge killer";
     default: return "";
     }
 }
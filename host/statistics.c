@@ -0,0 +1,113 @@
+#include <math.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "statistics.h"
+
+/**
+ * @brief Draws a random number through xorshift64*.
+ * A dedicated generator is used to not alter the sequence of numbers returned by `rand`.
+ *
+ * @param state The state of the generator. Must not be zero.
+ *
+ * @return A uniformly drawn 64-bit integer.
+**/
+static uint64_t next_bootstrap_random(uint64_t *state) {
+    *state ^= *state >> 12;
+    *state ^= *state << 25;
+    *state ^= *state >> 27;
+    return *state * 0x2545F4914F6CDD1DULL;
+}
+
+/**
+ * @brief Compares two measured times. Needed by `qsort`.
+**/
+static int compare_times(void const *a, void const *b) {
+    dpu_time const x = *(dpu_time const *)a, y = *(dpu_time const *)b;
+    return (x > y) - (x < y);
+}
+
+/**
+ * @brief Compares two doubles. Needed by `qsort`.
+**/
+static int compare_doubles(void const *a, void const *b) {
+    double const x = *(double const *)a, y = *(double const *)b;
+    return (x > y) - (x < y);
+}
+
+/**
+ * @brief Computes a percentile of a sorted list by linearly interpolating between the closest ranks.
+ *
+ * @param sorted The sorted values.
+ * @param length The length of the list.
+ * @param p The percentile to compute, as a value between 0 and 1.
+ *
+ * @return The percentile.
+**/
+static double get_percentile(dpu_time const sorted[], size_t const length, double const p) {
+    double const rank = p * (length - 1);
+    size_t const lower = (size_t)rank;
+    if (lower + 1 >= length) return sorted[length - 1];
+    return sorted[lower] + (rank - lower) * ((double)sorted[lower + 1] - sorted[lower]);
+}
+
+/**
+ * @brief Computes the median of a resample of a sorted list.
+ * Instead of sorting the resample, the multiplicities of the drawn indices are counted
+ * so that the median can be found through a single linear pass.
+ *
+ * @param sorted The sorted values from which to draw.
+ * @param length The length of the list.
+ * @param counts A buffer of `length` counters.
+ * @param state The state of the random number generator.
+ *
+ * @return The median of the resample.
+**/
+static double get_resampled_median(dpu_time const sorted[], size_t const length, size_t counts[],
+        uint64_t *state) {
+    memset(counts, 0, sizeof(size_t[length]));
+    for (size_t i = 0; i < length; i++)
+        counts[next_bootstrap_random(state) % length]++;
+    size_t const lower_rank = (length - 1) / 2, upper_rank = length / 2;
+    size_t seen = 0, i = 0;
+    while (seen + counts[i] <= lower_rank)
+        seen += counts[i++];
+    double const lower = sorted[i];
+    while (seen + counts[i] <= upper_rank)
+        seen += counts[i++];
+    return (lower + sorted[i]) / 2;
+}
+
+void summarise_times(dpu_time samples[], size_t const num_of_samples, struct summary *result) {
+    /* Welford’s algorithm, which cannot overflow unlike sums of squared cycle counts. */
+    double mean = 0, m2 = 0;
+    for (size_t i = 0; i < num_of_samples; i++) {
+        double const delta = samples[i] - mean;
+        mean += delta / (i + 1);
+        m2 += delta * (samples[i] - mean);
+    }
+    result->mean = mean;
+    result->std = (num_of_samples > 1) ? sqrt(m2 / (num_of_samples - 1)) : 0;
+
+    qsort(samples, num_of_samples, sizeof samples[0], compare_times);
+    result->median = get_percentile(samples, num_of_samples, 0.5);
+    result->p5 = get_percentile(samples, num_of_samples, 0.05);
+    result->p95 = get_percentile(samples, num_of_samples, 0.95);
+
+    /* Percentile bootstrap of the median. */
+    if (num_of_samples == 1) {
+        result->ci_low = result->ci_high = result->median;
+        return;
+    }
+    uint64_t state = 0x9E3779B97F4A7C15ULL;
+    size_t *counts = malloc(sizeof(size_t[num_of_samples]));
+    double *medians = malloc(sizeof(double[BOOTSTRAP_RESAMPLES]));
+    for (size_t b = 0; b < BOOTSTRAP_RESAMPLES; b++)
+        medians[b] = get_resampled_median(samples, num_of_samples, counts, &state);
+    qsort(medians, BOOTSTRAP_RESAMPLES, sizeof medians[0], compare_doubles);
+    result->ci_low = medians[(size_t)(0.025 * (BOOTSTRAP_RESAMPLES - 1))];
+    result->ci_high = medians[(size_t)(0.975 * (BOOTSTRAP_RESAMPLES - 1))];
+    free(counts);
+    free(medians);
+}
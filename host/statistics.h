@@ -0,0 +1,46 @@
+/**
+ * @file
+ * @brief Summarising measured runtimes through robust statistics.
+**/
+
+#ifndef _STATISTICS_H_
+#define _STATISTICS_H_
+
+#include <stddef.h>
+
+#include "communication.h"
+
+/// @brief How many resamples are drawn to compute the bootstrap confidence interval.
+#define BOOTSTRAP_RESAMPLES (1000)
+
+/// @brief The statistics printed for every sorting algorithm and input length.
+struct summary {
+    /// @brief The arithmetic mean of the measured times.
+    double mean;
+    /// @brief The (corrected) standard deviation of the measured times.
+    double std;
+    /// @brief The median of the measured times.
+    double median;
+    /// @brief The 5th percentile of the measured times.
+    double p5;
+    /// @brief The 95th percentile of the measured times.
+    double p95;
+    /// @brief The lower bound of the 95 % bootstrap confidence interval of the median.
+    double ci_low;
+    /// @brief The upper bound of the 95 % bootstrap confidence interval of the median.
+    double ci_high;
+};
+
+/**
+ * @brief Computes the mean, standard deviation, median, percentiles, and the confidence interval
+ * of the median of a list of measured times.
+ * @note The bootstrap uses its own random number generator
+ * so that the input generation through `rand` is left undisturbed.
+ *
+ * @param samples The measured times. They get sorted in the process.
+ * @param num_of_samples The length of the list.
+ * @param result Where to store the statistics.
+**/
+void summarise_times(dpu_time samples[], size_t const num_of_samples, struct summary *result);
+
+#endif  // _STATISTICS_H_
@@ -0,0 +1,131 @@
+#define _POSIX_C_SOURCE 200112L
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "statistics.h"
+#include "transfers.h"
+
+#ifndef DPU_FREQUENCY
+/// @brief The clock frequency of a DPU in MHz. Used to convert cycles into seconds.
+#define DPU_FREQUENCY (350)
+#endif
+
+/// @brief The names of the transfer APIs as printed in the column names.
+static char const * const transfer_api_names[nr_of_transfer_apis] = {
+    "copy_to",
+    "push_to",
+    "bcast_to",
+    "copy_from",
+    "push_from",
+};
+
+/**
+ * @brief Transfers the same number of bytes to or from every DPU once.
+ * All DPUs share the same host buffer since only the time is of interest.
+ *
+ * @param set The DPUs to transfer to or from.
+ * @param api How to transfer the data.
+ * @param buffer The host buffer holding at least `size` bytes.
+ * @param size The number of bytes per DPU. Must be divisible by `DMA_ALIGNMENT`.
+ *
+ * @return The time needed in nanoseconds.
+**/
+static dpu_time time_transfer(struct dpu_set_t set, enum transfer_api api, void *buffer,
+        size_t size) {
+    struct dpu_set_t dpu;
+    struct timespec start, end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    switch (api) {
+    case serial_to:
+        DPU_FOREACH(set, dpu) {
+            DPU_ASSERT(dpu_copy_to(dpu, "input", 0, buffer, size));
+        }
+        break;
+    case parallel_to:
+        DPU_FOREACH(set, dpu) {
+            DPU_ASSERT(dpu_prepare_xfer(dpu, buffer));
+        }
+        DPU_ASSERT(dpu_push_xfer(set, DPU_XFER_TO_DPU, "input", 0, size, DPU_XFER_DEFAULT));
+        break;
+    case broadcast_to:
+        DPU_ASSERT(dpu_broadcast_to(set, "input", 0, buffer, size, DPU_XFER_DEFAULT));
+        break;
+    case serial_from:
+        DPU_FOREACH(set, dpu) {
+            DPU_ASSERT(dpu_copy_from(dpu, "input", 0, buffer, size));
+        }
+        break;
+    case parallel_from:
+        DPU_FOREACH(set, dpu) {
+            DPU_ASSERT(dpu_prepare_xfer(dpu, buffer));
+        }
+        DPU_ASSERT(dpu_push_xfer(set, DPU_XFER_FROM_DPU, "input", 0, size, DPU_XFER_DEFAULT));
+        break;
+    default:
+        printf("‘%d’ is no known transfer API!\n", api);
+        abort();
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    return (end.tv_sec - start.tv_sec) * 1000000000ULL + end.tv_nsec - start.tv_nsec;
+}
+
+/**
+ * @brief Measures the median time of a transfer.
+ *
+ * @param set The DPUs to transfer to or from.
+ * @param api How to transfer the data.
+ * @param buffer The host buffer holding at least `size` bytes.
+ * @param size The number of bytes per DPU.
+ * @param reps How often to measure the transfer.
+ * @param samples Space for `reps` measurements.
+ *
+ * @return The median time in seconds.
+**/
+static double median_transfer(struct dpu_set_t set, enum transfer_api api, void *buffer,
+        size_t size, uint32_t reps, dpu_time samples[]) {
+    time_transfer(set, api, buffer, size);  // warm-up
+    for (uint32_t rep = 0; rep < reps; rep++)
+        samples[rep] = time_transfer(set, api, buffer, size);
+    struct summary s;
+    summarise_times(samples, reps, &s);
+    return s.median / 1e9;
+}
+
+void benchmark_transfers(struct dpu_set_t set, uint32_t nr_of_dpus, uint32_t reps,
+        uint32_t const lengths[], double const sort_cycles[], size_t num_of_lengths) {
+    size_t const max_size = sizeof(T[LOAD_INTO_MRAM]);
+    void * const buffer = calloc(max_size, 1);
+    dpu_time * const samples = malloc(sizeof(dpu_time[reps]));
+
+    /* Bandwidth in GB/s over all DPUs */
+    printf("# transfers: DPUs=%u, reps=%u, unit=GB/s\nsize", nr_of_dpus, reps);
+    for (enum transfer_api api = 0; api < nr_of_transfer_apis; api++)
+        printf("\t%s", transfer_api_names[api]);
+    printf("\n");
+    for (size_t size = MIN_TRANSFER_SIZE; size <= max_size; size *= 2) {
+        printf("%-9zu", size);
+        for (enum transfer_api api = 0; api < nr_of_transfer_apis; api++) {
+            double const seconds = median_transfer(set, api, buffer, size, reps, samples);
+            printf("\t%9.3f", (double)size * nr_of_dpus / seconds / 1e9);
+        }
+        printf("\n");
+    }
+
+    /* Share of the transfers in the time of offloading a sort */
+    printf("# offload: DPUs=%u, transfers=push_to+push_from, unit=s\n"
+            "n\tupload download sort transfer_share\n", nr_of_dpus);
+    for (size_t li = 0; li < num_of_lengths; li++) {
+        size_t const size = DMA_ALIGNED(sizeof(T[lengths[li]]));
+        double const upload = median_transfer(set, parallel_to, buffer, size, reps, samples);
+        double const download = median_transfer(set, parallel_from, buffer, size, reps, samples);
+        double const sort = sort_cycles[li] / (DPU_FREQUENCY * 1e6);
+        printf("%-4u\t%.6f %.6f %.6f %5.3f\n", lengths[li], upload, download, sort,
+                (upload + download) / (upload + download + sort));
+    }
+
+    free(samples);
+    free(buffer);
+}
@@ -0,0 +1,51 @@
+/**
+ * @file
+ * @brief Measuring the bandwidth of transfers between the host and the DPUs.
+**/
+
+#ifndef _TRANSFERS_H_
+#define _TRANSFERS_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <dpu.h>
+
+#include "communication.h"
+
+/// @brief The smallest number of bytes transferred to or from each DPU.
+#define MIN_TRANSFER_SIZE (8)
+
+/// @brief The ways of moving data between the host and the DPUs which are measured.
+enum transfer_api {
+    /// @brief `dpu_copy_to` called for one DPU after the other.
+    serial_to,
+    /// @brief `dpu_push_xfer` to all DPUs at once.
+    parallel_to,
+    /// @brief `dpu_broadcast_to`, sending the same buffer to all DPUs.
+    broadcast_to,
+    /// @brief `dpu_copy_from` called for one DPU after the other.
+    serial_from,
+    /// @brief `dpu_push_xfer` from all DPUs at once.
+    parallel_from,
+    nr_of_transfer_apis,
+};
+
+/**
+ * @brief Measures the bandwidth of each transfer API for all sizes from `MIN_TRANSFER_SIZE` bytes
+ * to the size of the MRAM array `input`, doubling the size each time.
+ * Afterwards, compares the time needed to upload and download each input length
+ * to the predicted time of sorting it.
+ * Both results are printed as tables.
+ *
+ * @param set The allocated DPUs, loaded with a binary which holds the symbol `input`.
+ * @param nr_of_dpus The number of DPUs in the set.
+ * @param reps How often each transfer is measured. The median time is used.
+ * @param lengths The input lengths to compare the transfers and the sorting for.
+ * @param sort_cycles The predicted cycles of sorting each input length, NaN if unknown.
+ * @param num_of_lengths The number of input lengths.
+**/
+void benchmark_transfers(struct dpu_set_t set, uint32_t nr_of_dpus, uint32_t reps,
+        uint32_t const lengths[], double const sort_cycles[], size_t num_of_lengths);
+
+#endif  // _TRANSFERS_H_
@@ -0,0 +1,181 @@
+#define _POSIX_C_SOURCE 200112L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include "verification.h"
+
+/// @brief The maximum number of elements checked at once by a thread.
+#define CHUNK_LENGTH (1 << 16)
+/// @brief The maximum number of threads per verification.
+#define MAX_WORKERS (64)
+
+/// @brief A consecutive range of elements within a sorted part.
+struct chunk {
+    /// @brief The repetition to which the chunk belongs.
+    uint32_t rep;
+    /// @brief The part to which the chunk belongs.
+    uint32_t part;
+    /// @brief The first index of the chunk.
+    size_t from;
+    /// @brief The index after the last element of the chunk.
+    size_t to;
+    /// @brief The index after the last element of the part.
+    size_t part_end;
+    /// @brief How often an element is bigger than its successor.
+    size_t inversions;
+    /// @brief The sum of the hashes of the original elements minus that of the sorted ones.
+    uint64_t difference;
+};
+
+/// @brief The arguments passed to each thread checking chunks.
+struct worker_data {
+    /// @brief The verification to which the chunks belong.
+    struct verification *job;
+    /// @brief All chunks of the verification.
+    struct chunk *chunks;
+    /// @brief The number of chunks.
+    size_t num_of_chunks;
+    /// @brief The Id of the thread.
+    size_t id;
+    /// @brief The number of threads.
+    size_t nr_workers;
+};
+
+/**
+ * @brief Counts the inversions within a chunk and computes the difference of the hash sums.
+ * The last element of the chunk is also compared to the first element of the next chunk.
+ * Both loops are free of branches so that the compiler can vectorise them.
+ *
+ * @param job The verification to which the chunk belongs.
+ * @param chunk The chunk to check.
+**/
+static void check_chunk(struct verification const *job, struct chunk *chunk) {
+    T const * const original = &job->original[(size_t)chunk->rep * job->offset];
+    T const * const sorted = &job->sorted[(size_t)chunk->rep * job->offset];
+    size_t const last = (chunk->to < chunk->part_end) ? chunk->to + 1 : chunk->to;
+    size_t inversions = 0;
+    for (size_t i = chunk->from; i + 1 < last; i++)
+        inversions += (sorted[i] > sorted[i + 1]);
+    uint64_t difference = 0;
+    for (size_t i = chunk->from; i < chunk->to; i++)
+        difference += hash_key(original[i]) - hash_key(sorted[i]);
+    chunk->inversions = inversions;
+    chunk->difference = difference;
+}
+
+/**
+ * @brief Checks every `nr_workers`-th chunk, starting with the one of the index `id`.
+ *
+ * @param arg The `worker_data` of the thread.
+ *
+ * @return Nothing.
+**/
+static void *check_chunks(void *arg) {
+    struct worker_data const *me = arg;
+    for (size_t c = me->id; c < me->num_of_chunks; c += me->nr_workers)
+        check_chunk(me->job, &me->chunks[c]);
+    return NULL;
+}
+
+/**
+ * @brief Splits all parts of all repetitions into chunks, lets several threads check them,
+ * and reports every part which is not sorted or no permutation of the original part.
+ *
+ * @param arg The `verification` to run.
+ *
+ * @return Nothing.
+**/
+static void *verify(void *arg) {
+    struct verification *job = arg;
+    size_t num_of_chunks = 0, from, to;
+    for (uint32_t part = 0; part < job->parts; part++) {
+        get_part_range(job->length, job->part_length, job->parts, part, &from, &to);
+        num_of_chunks += DIV_CEIL(to - from, CHUNK_LENGTH);
+    }
+    num_of_chunks *= job->reps;
+    struct chunk *chunks = malloc(sizeof(struct chunk[num_of_chunks + 1]));
+    size_t c = 0;
+    for (uint32_t rep = 0; rep < job->reps; rep++) {
+        for (uint32_t part = 0; part < job->parts; part++) {
+            get_part_range(job->length, job->part_length, job->parts, part, &from, &to);
+            for (; from < to; from += CHUNK_LENGTH) {
+                chunks[c++] = (struct chunk){
+                    .rep = rep,
+                    .part = part,
+                    .from = from,
+                    .to = (from + CHUNK_LENGTH < to) ? from + CHUNK_LENGTH : to,
+                    .part_end = to,
+                };
+            }
+        }
+    }
+
+    long const cores = sysconf(_SC_NPROCESSORS_ONLN);
+    size_t nr_workers = (cores > 0) ? (size_t)cores : 1;
+    nr_workers = (nr_workers > MAX_WORKERS) ? MAX_WORKERS : nr_workers;
+    nr_workers = (nr_workers > num_of_chunks) ? num_of_chunks : nr_workers;
+    pthread_t workers[MAX_WORKERS];
+    struct worker_data args[MAX_WORKERS];
+    for (size_t w = 0; w < nr_workers; w++)
+        args[w] = (struct worker_data){ job, chunks, num_of_chunks, w, nr_workers };
+    for (size_t w = 1; w < nr_workers; w++)
+        pthread_create(&workers[w], NULL, check_chunks, &args[w]);
+    if (nr_workers != 0)
+        check_chunks(&args[0]);
+    for (size_t w = 1; w < nr_workers; w++)
+        pthread_join(workers[w], NULL);
+
+    /* Combine the results of all chunks of the same part. */
+    for (size_t first = 0; first < num_of_chunks;) {
+        size_t inversions = 0;
+        uint64_t difference = 0;
+        size_t i = first;
+        for (; i < num_of_chunks && chunks[i].rep == chunks[first].rep
+                && chunks[i].part == chunks[first].part; i++) {
+            inversions += chunks[i].inversions;
+            difference += chunks[i].difference;
+        }
+        if (inversions || difference) {
+            printf(ANSI_COLOR_RED "Verification of ‘%s’ failed: part %u of repetition %u is %s!\n"
+                    ANSI_COLOR_RESET, job->name, chunks[first].part, chunks[first].rep,
+                    (inversions) ? "not sorted" : "no permutation of the input");
+            job->failures++;
+        }
+        first = i;
+    }
+    free(chunks);
+    return NULL;
+}
+
+void init_verification(struct verification *job) {
+    job->sorted = malloc(sizeof(T[LOAD_INTO_MRAM]));
+    job->running = false;
+}
+
+void free_verification(struct verification *job) {
+    finish_verification(job);
+    free(job->sorted);
+}
+
+void start_verification(struct verification *job, T const original[], char const *name,
+        struct dpu_arguments const *args, struct dpu_results const *results) {
+    job->original = original;
+    job->name = name;
+    job->reps = args->reps;
+    job->offset = args->offset;
+    job->length = results->sorted_length;
+    job->part_length = args->part_length;
+    job->parts = results->sorted_parts;
+    job->failures = 0;
+    job->running = true;
+    pthread_create(&job->thread, NULL, verify, job);
+}
+
+size_t finish_verification(struct verification *job) {
+    if (!job->running) return 0;
+    pthread_join(job->thread, NULL);
+    job->running = false;
+    return job->failures;
+}
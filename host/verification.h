@@ -0,0 +1,102 @@
+/**
+ * @file
+ * @brief Verifying the data sorted by the DPU on the host, in the background.
+**/
+
+#ifndef _VERIFICATION_H_
+#define _VERIFICATION_H_
+
+#include <pthread.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "common.h"
+#include "communication.h"
+
+/// @brief A verification of all repetitions of one launch, run by a background thread.
+struct verification {
+    /// @brief The thread running the verification.
+    pthread_t thread;
+    /// @brief Whether the thread has been started but not yet joined.
+    bool running;
+    /// @brief The sorted data as downloaded from the DPU.
+    T *sorted;
+    /// @brief The data as uploaded to the DPU.
+    T const *original;
+    /// @brief The name of the sorting algorithm which sorted the data.
+    char const *name;
+    /// @brief The number of repetitions.
+    uint32_t reps;
+    /// @brief The distance between the data of two repetitions.
+    uint32_t offset;
+    /// @brief The number of sorted elements per repetition.
+    uint32_t length;
+    /// @brief The length of each independently sorted part, except for the last one.
+    uint32_t part_length;
+    /// @brief The number of independently sorted parts per repetition.
+    uint32_t parts;
+    /// @brief How many parts were found to be incorrectly sorted.
+    size_t failures;
+};
+
+/**
+ * @brief Computes the range of a sorted part within a repetition, clipped to the sorted elements.
+ *
+ * @param length The number of sorted elements per repetition.
+ * @param part_length The length of each part, except for the last one.
+ * @param parts The number of parts per repetition.
+ * @param part The index of the part.
+ * @param from Where to store the first index of the part.
+ * @param to Where to store the index after the last element of the part.
+**/
+static inline void get_part_range(uint32_t const length, uint32_t const part_length,
+        uint32_t const parts, uint32_t const part, size_t *from, size_t *to) {
+    *from = (size_t)part * part_length;
+    *to = (part == parts - 1) ? length : *from + part_length;
+    *to = (*to < length) ? *to : length;
+    *from = (*from < *to) ? *from : *to;
+}
+
+/**
+ * @brief Allocates the buffer into which the sorted data are downloaded.
+ * @sa free_verification
+ *
+ * @param job The verification to set up.
+**/
+void init_verification(struct verification *job);
+
+/**
+ * @brief Frees the buffer of a verification. Waits for it to finish if still running.
+ * @sa init_verification
+ *
+ * @param job The verification to free.
+**/
+void free_verification(struct verification *job);
+
+/**
+ * @brief Starts checking in the background whether the data in the buffer of the verification
+ * are sorted and a permutation of the original data.
+ * The check is split among several threads, each comparing neighbours
+ * and summing the hashes of both the original and the sorted elements.
+ * @sa finish_verification
+ *
+ * @param job The verification whose buffer holds the sorted data. Must not be running.
+ * @param original The data which were uploaded. Must not be changed until the job is finished.
+ * @param name The name of the sorting algorithm.
+ * @param args The arguments sent to the DPU.
+ * @param results The results sent back by the DPU.
+**/
+void start_verification(struct verification *job, T const original[], char const *name,
+        struct dpu_arguments const *args, struct dpu_results const *results);
+
+/**
+ * @brief Waits for a verification to finish. Does nothing if it is not running.
+ * @sa start_verification
+ *
+ * @param job The verification to wait for.
+ *
+ * @return How many incorrectly sorted parts were found.
+**/
+size_t finish_verification(struct verification *job);
+
+#endif  // _VERIFICATION_H_
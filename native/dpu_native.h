@@ -0,0 +1,176 @@
+/**
+ * @file
+ * @brief Host-native stand-ins for the parts of the DPU runtime used by the sorting algorithms.
+ *
+ * MRAM and WRAM are ordinary host memory, tasklets are threads, and DMAs are copies.
+ * The constraints of the DPU (alignment and size of DMAs, size of the WRAM heap) are asserted
+ * so that violations are caught before running on actual hardware.
+ * All headers of the DPU runtime found in this folder merely include this file.
+**/
+
+#ifndef _DPU_NATIVE_H_
+#define _DPU_NATIVE_H_
+
+#include <assert.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/* attributes.h, defs.h, dpuconst.h */
+
+#define __host
+#define __keep __attribute__((used))
+#define __noinline __attribute__((noinline))
+#define __dma_aligned __attribute__((aligned(8)))
+#define __mram_ptr
+/// @brief MRAM arrays are aligned to pages so that sequential readers never load data before them.
+#define __mram_noinit __attribute__((aligned(4096)))
+#define __mram_noinit_keep __attribute__((aligned(4096), used))
+#define __mram __mram_noinit
+#define __STR_AUX(x) #x
+#define __STR(x) __STR_AUX(x)
+
+#ifndef MIN
+#define MIN(a, b) (((a) < (b)) ? (a) : (b))
+#endif
+#ifndef MAX
+#define MAX(a, b) (((a) > (b)) ? (a) : (b))
+#endif
+
+/// @brief The binary logarithm of the MRAM size.
+#define __DPU_MRAM_SIZE_LOG2 (26)
+
+/// @brief The Id of a tasklet.
+typedef uint32_t sysname_t;
+
+/// @brief The Id of the calling tasklet. Set by the tasklet emulator.
+extern _Thread_local sysname_t native_me;
+
+static inline sysname_t me(void) {
+    return native_me;
+}
+
+/* memmram_utils.h */
+
+#define DMA_ALIGNMENT (8)
+#define DMA_OFF_MASK (DMA_ALIGNMENT - 1)
+#define ALIGN_MASK(x, mask) (((x) + (mask)) & ~(mask))
+#define ALIGN(x, a) ALIGN_MASK((x), (a)-1)
+#define DMA_ALIGNED(x) ALIGN(x, DMA_ALIGNMENT)
+
+/* mram.h */
+
+/**
+ * @brief Copies data from MRAM to WRAM.
+ * Asserts that both addresses are aligned for DMAs and that the size is between 8 and 2048 bytes.
+**/
+void mram_read(void const __mram_ptr *from, void *to, unsigned int nb_of_bytes);
+
+/**
+ * @brief Copies data from WRAM to MRAM.
+ * Asserts that both addresses are aligned for DMAs and that the size is between 8 and 2048 bytes.
+**/
+void mram_write(void const *from, void __mram_ptr *to, unsigned int nb_of_bytes);
+
+/* alloc.h, dpuruntime.h, atomic_bit.h */
+
+/// @brief The start of the free space in the emulated WRAM heap.
+extern void *native_heap_pointer;
+#define __HEAP_POINTER (native_heap_pointer)
+/// @brief The first address after the emulated WRAM heap.
+extern void * const native_heap_end;
+#define WRAM_HEAP_END ((uintptr_t)native_heap_end)
+/// @brief The size of a pointer into the emulated WRAM, which is one of the host.
+#define WRAM_POINTER_SIZE (sizeof(void *))
+
+/// @brief Allocates memory on the WRAM heap. Not thread-safe.
+void *mem_alloc_nolock(size_t size);
+/// @brief Allocates memory on the WRAM heap.
+void *mem_alloc(size_t size);
+/// @brief Frees the whole WRAM heap.
+void mem_reset(void);
+
+#define ATOMIC_BIT_EXTERN(name) extern pthread_mutex_t native_atomic_bit_##name
+#define ATOMIC_BIT_ACQUIRE(name) pthread_mutex_lock(&native_atomic_bit_##name)
+#define ATOMIC_BIT_RELEASE(name) pthread_mutex_unlock(&native_atomic_bit_##name)
+
+/* barrier.h, handshake.h, mutex.h */
+
+/// @brief A barrier which can be statically initialised, unlike `pthread_barrier_t`.
+typedef struct barrier_t {
+    pthread_mutex_t lock;
+    pthread_cond_t all_arrived;
+    unsigned count;
+    unsigned waiting;
+    unsigned generation;
+} barrier_t;
+
+#define BARRIER_INIT(name, counter) \
+barrier_t name = { PTHREAD_MUTEX_INITIALIZER, PTHREAD_COND_INITIALIZER, (counter), 0, 0 }
+
+void barrier_wait(barrier_t *barrier);
+
+/// @brief Blocks until another tasklet waits for the calling one.
+int handshake_notify(void);
+/// @brief Blocks until the given tasklet notifies.
+int handshake_wait_for(sysname_t notifier);
+
+typedef pthread_mutex_t *mutex_id_t;
+
+#define MUTEX_INIT(name)                                            \
+pthread_mutex_t native_mutex_##name = PTHREAD_MUTEX_INITIALIZER;   \
+mutex_id_t const name = &native_mutex_##name
+
+static inline void mutex_lock(mutex_id_t mutex) {
+    pthread_mutex_lock(mutex);
+}
+
+static inline void mutex_unlock(mutex_id_t mutex) {
+    pthread_mutex_unlock(mutex);
+}
+
+/// @brief Not part of the DPU runtime: lets a busy-waiting tasklet give way to the one it waits for,
+/// which matters if there are fewer cores than tasklets.
+#define SPIN_WAIT() sched_yield()
+
+/* perfcounter.h */
+
+typedef uint64_t perfcounter_t;
+typedef enum perfcounter_config_t { COUNT_SAME, COUNT_CYCLES, COUNT_INSTRUCTIONS } perfcounter_config_t;
+
+/**
+ * @brief Resets the emulated performance counter if requested.
+ * The counter is derived from the wall-clock time and the DPU frequency.
+**/
+perfcounter_t perfcounter_config(perfcounter_config_t config, bool reset_value);
+/// @brief Returns the emulated cycles since the last reset.
+perfcounter_t perfcounter_get(void);
+
+/* seqread.h */
+
+typedef uintptr_t seqreader_buffer_t;
+
+typedef struct seqreader_t {
+    seqreader_buffer_t wram_cache;
+    uintptr_t mram_addr;
+} seqreader_t;
+
+/**
+ * @brief The emulation of the built-in used by sequential readers.
+ * Advances the pointer and loads the next page if the current one has been passed.
+**/
+uintptr_t native_seqread_get(uintptr_t ptr, uint32_t inc, seqreader_t *reader, uint32_t page_size);
+#define __builtin_dpu_seqread_get native_seqread_get
+
+/// @brief Allocates a buffer for a sequential reader.
+seqreader_buffer_t seqread_alloc(void);
+/// @brief Sets a sequential reader to an MRAM address and loads the first page.
+void *seqread_init(seqreader_buffer_t cache, void __mram_ptr *mram_addr, seqreader_t *reader);
+/// @brief Advances the pointer of a sequential reader.
+void *seqread_get(void *ptr, uint32_t inc, seqreader_t *reader);
+/// @brief Returns the MRAM address of the current item of a sequential reader.
+void __mram_ptr *seqread_tell(void *ptr, seqreader_t *reader);
+
+#endif  // _DPU_NATIVE_H_
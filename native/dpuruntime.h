@@ -0,0 +1 @@
+#include "dpu_native.h"
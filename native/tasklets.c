@@ -0,0 +1,324 @@
+/**
+ * @file
+ * @brief Emulation of the DPU runtime through threads and a driver running a benchmark natively.
+ *
+ * The benchmark is compiled with `main` renamed to `dpu_main`.
+ * Each launch spawns `NR_TASKLETS` threads executing `dpu_main`.
+ * Afterwards, the sorted data are verified like in the host’s verification mode.
+**/
+
+#define _POSIX_C_SOURCE 200112L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "dpu_native.h"
+#include "common.h"
+#include "communication.h"
+#include "random_distribution.h"
+#include "verification.h"
+
+#ifndef DPU_FREQUENCY
+/// @brief The clock frequency of a DPU in MHz. Used to convert times into cycles.
+#define DPU_FREQUENCY (350)
+#endif
+
+/// @brief The size of the WRAM of a DPU.
+#define WRAM_SIZE (64 * 1024)
+
+_Thread_local sysname_t native_me;
+
+/* WRAM heap */
+
+static uint8_t wram_heap[WRAM_SIZE] __attribute__((aligned(4096)));
+void *native_heap_pointer = wram_heap;
+void * const native_heap_end = wram_heap + WRAM_SIZE;
+pthread_mutex_t native_atomic_bit___heap_pointer = PTHREAD_MUTEX_INITIALIZER;
+
+void *mem_alloc_nolock(size_t size) {
+    void * const allocated = native_heap_pointer;
+    size = DMA_ALIGNED(size);
+    assert((uint8_t *)native_heap_pointer + size <= wram_heap + WRAM_SIZE && "WRAM heap exhausted!");
+    native_heap_pointer = (uint8_t *)native_heap_pointer + size;
+    return allocated;
+}
+
+void *mem_alloc(size_t size) {
+    ATOMIC_BIT_ACQUIRE(__heap_pointer);
+    void * const allocated = mem_alloc_nolock(size);
+    ATOMIC_BIT_RELEASE(__heap_pointer);
+    return allocated;
+}
+
+void mem_reset(void) {
+    native_heap_pointer = wram_heap;
+}
+
+/* DMAs */
+
+/**
+ * @brief Copies memory without being instrumented by sanitisers.
+ * Sequential readers legitimately load whole pages, which may extend beyond the MRAM arrays.
+**/
+__attribute__((no_sanitize_address, noinline))
+static void dma_copy(void *to, void const *from, unsigned int nb_of_bytes) {
+    uint64_t *dst = to;
+    uint64_t const *src = from;
+    for (unsigned int i = 0; i < nb_of_bytes / 8; i++)
+        dst[i] = src[i];
+}
+
+void mram_read(void const __mram_ptr *from, void *to, unsigned int nb_of_bytes) {
+    assert(!((uintptr_t)from & DMA_OFF_MASK) && "Unaligned MRAM address!");
+    assert(!((uintptr_t)to & DMA_OFF_MASK) && "Unaligned WRAM address!");
+    assert(nb_of_bytes >= 8 && nb_of_bytes <= 2048 && !(nb_of_bytes & DMA_OFF_MASK));
+    dma_copy(to, from, nb_of_bytes);
+}
+
+void mram_write(void const *from, void __mram_ptr *to, unsigned int nb_of_bytes) {
+    assert(!((uintptr_t)from & DMA_OFF_MASK) && "Unaligned WRAM address!");
+    assert(!((uintptr_t)to & DMA_OFF_MASK) && "Unaligned MRAM address!");
+    assert(nb_of_bytes >= 8 && nb_of_bytes <= 2048 && !(nb_of_bytes & DMA_OFF_MASK));
+    dma_copy(to, from, nb_of_bytes);
+}
+
+/* Sequential readers */
+
+uintptr_t native_seqread_get(uintptr_t ptr, uint32_t inc, seqreader_t *reader, uint32_t page_size) {
+    ptr += inc;
+    if (ptr >= reader->wram_cache + page_size) {
+        reader->mram_addr += page_size;
+        mram_read((void __mram_ptr *)reader->mram_addr, (void *)reader->wram_cache, 2 * page_size);
+        ptr -= page_size;
+    }
+    return ptr;
+}
+
+seqreader_buffer_t seqread_alloc(void) {
+    return (seqreader_buffer_t)mem_alloc(2 * SEQREAD_CACHE_SIZE);
+}
+
+void *seqread_init(seqreader_buffer_t cache, void __mram_ptr *mram_addr, seqreader_t *reader) {
+    reader->wram_cache = cache;
+    reader->mram_addr = (uintptr_t)mram_addr & ~(uintptr_t)(SEQREAD_CACHE_SIZE - 1);
+    mram_read((void __mram_ptr *)reader->mram_addr, (void *)cache, 2 * SEQREAD_CACHE_SIZE);
+    return (void *)(cache + ((uintptr_t)mram_addr & (SEQREAD_CACHE_SIZE - 1)));
+}
+
+void *seqread_get(void *ptr, uint32_t inc, seqreader_t *reader) {
+    return (void *)native_seqread_get((uintptr_t)ptr, inc, reader, SEQREAD_CACHE_SIZE);
+}
+
+void __mram_ptr *seqread_tell(void *ptr, seqreader_t *reader) {
+    return (void __mram_ptr *)(reader->mram_addr + ((uintptr_t)ptr - reader->wram_cache));
+}
+
+/* Synchronisation */
+
+void barrier_wait(barrier_t *barrier) {
+    pthread_mutex_lock(&barrier->lock);
+    unsigned const generation = barrier->generation;
+    if (++barrier->waiting == barrier->count) {
+        barrier->waiting = 0;
+        barrier->generation++;
+        pthread_cond_broadcast(&barrier->all_arrived);
+    } else {
+        while (generation == barrier->generation)
+            pthread_cond_wait(&barrier->all_arrived, &barrier->lock);
+    }
+    pthread_mutex_unlock(&barrier->lock);
+}
+
+static pthread_mutex_t handshake_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t handshake_changed = PTHREAD_COND_INITIALIZER;
+static bool notifying[NR_TASKLETS];
+
+int handshake_notify(void) {
+    pthread_mutex_lock(&handshake_lock);
+    notifying[me()] = true;
+    pthread_cond_broadcast(&handshake_changed);
+    while (notifying[me()])
+        pthread_cond_wait(&handshake_changed, &handshake_lock);
+    pthread_mutex_unlock(&handshake_lock);
+    return 0;
+}
+
+int handshake_wait_for(sysname_t notifier) {
+    pthread_mutex_lock(&handshake_lock);
+    while (!notifying[notifier])
+        pthread_cond_wait(&handshake_changed, &handshake_lock);
+    notifying[notifier] = false;
+    pthread_cond_broadcast(&handshake_changed);
+    pthread_mutex_unlock(&handshake_lock);
+    return 0;
+}
+
+/* Performance counter */
+
+static struct timespec perfcounter_start;
+
+/// @brief Returns the number of DPU cycles which would have passed since the given time.
+static perfcounter_t cycles_since(struct timespec const *start) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    uint64_t const ns = (now.tv_sec - start->tv_sec) * 1000000000ULL + now.tv_nsec - start->tv_nsec;
+    return ns * DPU_FREQUENCY / 1000;
+}
+
+perfcounter_t perfcounter_config(perfcounter_config_t config, bool reset_value) {
+    (void)config;
+    perfcounter_t const old_value = cycles_since(&perfcounter_start);
+    if (reset_value)
+        clock_gettime(CLOCK_MONOTONIC, &perfcounter_start);
+    return old_value;
+}
+
+perfcounter_t perfcounter_get(void) {
+    return cycles_since(&perfcounter_start);
+}
+
+/* Driver */
+
+/// @brief The state for generating the input. Defined by every benchmark which generates inputs
+/// in debug mode; this fallback serves the others.
+__attribute__((weak)) struct xorshift input_rngs[NR_TASKLETS];
+/// @brief Where MRAM sorts may leave sorted parts. Defined by every benchmark which has one;
+/// this fallback serves the others.
+__attribute__((weak)) T output[LOAD_INTO_MRAM];
+
+extern struct dpu_arguments host_to_dpu;
+extern struct dpu_results dpu_to_host;
+extern T input[LOAD_INTO_MRAM];
+extern union algo_to_test algos[];
+extern size_t num_of_algos;
+int dpu_main(void);
+
+/**
+ * @brief Sets the Id of the thread and runs the benchmark as a tasklet.
+ *
+ * @param arg The Id of the tasklet.
+ *
+ * @return Nothing.
+**/
+static void *run_tasklet(void *arg) {
+    native_me = (sysname_t)(uintptr_t)arg;
+    dpu_main();
+    return NULL;
+}
+
+/// @brief Launches the benchmark on `NR_TASKLETS` threads and waits for them to finish.
+static void launch(void) {
+    pthread_t tasklets[NR_TASKLETS];
+    for (uintptr_t t = 0; t < NR_TASKLETS; t++)
+        pthread_create(&tasklets[t], NULL, run_tasklet, (void *)t);
+    for (size_t t = 0; t < NR_TASKLETS; t++)
+        pthread_join(tasklets[t], NULL);
+}
+
+static void usage(void) {
+    fprintf(stderr,
+        "Usage: ./<benchmark>_native [options]"
+        "\n"
+        "\nOptions:"
+        "\n    -h          help"
+        "\n    -n <uint>   input length [default: 4096]"
+        "\n    -r <uint>   number of repetitions [default: 1]"
+        "\n    -a <uint>   index of the sorting algorithm to run [default: all]"
+        "\n    -t <uint>   type of the distribution to draw from, as on the host [default: uniform]"
+        "\n    -p <uint>   parameter to pass to distribution, as on the host [default: 0]"
+        "\n    -s <uint>   seed of the random numbers [default: 1]"
+        "\n    -u <uint>   number of tasklets which MRAM sorts use [default: NR_TASKLETS]"
+        "\n"
+    );
+}
+
+int main(int argc, char **argv) {
+    uint32_t length = 4096, reps = 1, seed = 1, active = NR_TASKLETS;
+    int64_t only_algo = -1;
+    enum dist dist_type = uniform;
+    T dist_param = 0;
+    int opt;
+    while ((opt = getopt(argc, argv, "hn:r:a:t:p:s:u:")) >= 0) {
+        switch (opt) {
+        case 'n': length = atof(optarg); break;
+        case 'r': reps = atof(optarg); break;
+        case 'a': only_algo = atof(optarg); break;
+        case 't': dist_type = atof(optarg); break;
+        case 'p': dist_param = atof(optarg); break;
+        case 's': seed = atof(optarg); break;
+        case 'u': active = atof(optarg); break;
+        default: usage(); exit(opt != 'h');
+        }
+    }
+    uint32_t const offset = DMA_ALIGNED(length * sizeof(T)) / sizeof(T);
+    if (length == 0 || reps == 0 || reps > MAX_REPS_PER_LAUNCH
+            || (uint64_t)offset * reps > LOAD_INTO_MRAM || dist_type >= nr_of_dists
+            || active == 0 || active > NR_TASKLETS) {
+        fprintf(stderr, "Invalid length, number of repetitions, distribution, or tasklets!\n");
+        exit(EXIT_FAILURE);
+    }
+    // As on the host, fewer tasklets sort if the last ones would get no items.
+    uint32_t const part_length = DMA_ALIGNED(DIV_CEIL(length, active) * sizeof(T)) / sizeof(T);
+    active = DIV_CEIL(length, part_length);
+
+    /* Generate the input with the generators of the DPU, acting as tasklet 0. */
+    T * const original = malloc(sizeof(T[offset * reps]));
+    T * const cache = mem_alloc(MAX_TRANSFER_SIZE_TRIPLE);
+    input_rngs[0] = seed_xs(seed);
+    for (uint32_t rep = 0; rep < reps; rep++) {
+        // The generators need a DMA-aligned end, so the padding after the input is drawn, too.
+        // It is sorted along with the input anyway.
+        mram_range const range = { rep * offset, rep * offset + offset };
+        generate_input_distribution_mram(input, cache, &range, dist_type, dist_param);
+    }
+    memcpy(original, input, sizeof(T[offset * reps]));
+    mem_reset();
+
+    struct verification job;
+    init_verification(&job);
+    size_t failures = 0;
+    printf("# n=%u, reps=%u, dist type=%u, dist param=%"T_QUALIFIER", TYPE=%s, NR_TASKLETS=%d, "
+            "active tasklets=%u, emulated DPU_FREQUENCY=%u\n",
+            length, reps, dist_type, dist_param, TYPE_NAME, NR_TASKLETS, active, DPU_FREQUENCY);
+    for (size_t id = 0; id < num_of_algos; id++) {
+        if (only_algo >= 0 && (size_t)only_algo != id) continue;
+        memcpy(input, original, sizeof(T[offset * reps]));
+        host_to_dpu = (struct dpu_arguments){
+            .reps = reps,
+            .length = length,
+            .offset = offset,
+            .part_length = part_length,
+            .basic_seed = seed,
+            .algo_index = id,
+            .write_back = true,
+            .active_tasklets = active,
+        };
+        launch();
+        memcpy(job.sorted, input, sizeof(T[offset * reps]));
+        for (uint32_t rep = 0; rep < reps && dpu_to_host.parts_in_output; rep++) {
+            for (uint32_t part = 0; part < dpu_to_host.sorted_parts; part++) {
+                if (!(dpu_to_host.parts_in_output >> part & 1)) continue;
+                size_t from, to;
+                get_part_range(dpu_to_host.sorted_length, host_to_dpu.part_length,
+                        dpu_to_host.sorted_parts, part, &from, &to);
+                memcpy(&job.sorted[rep * offset + from], &output[rep * offset + from],
+                        sizeof(T[to - from]));
+            }
+        }
+        start_verification(&job, original, algos[id].data.name, &host_to_dpu, &dpu_to_host);
+        size_t const new_failures = finish_verification(&job);
+        failures += new_failures;
+        printf("%-16s", algos[id].data.name);
+        for (uint32_t rep = 0; rep < reps; rep++)
+            printf(" %10lu", (unsigned long)dpu_to_host.times[rep]);
+        printf("  %s\n", (new_failures) ? "FAILED" : "ok");
+    }
+    if (dpu_to_host.starting_run_length != 0)
+        printf("# starting run length=%u\n", dpu_to_host.starting_run_length);
+    free_verification(&job);
+    free(original);
+    return (failures) ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,80 @@
+#!/bin/bash
+
+# Measures DMAs of all sizes and alignments of the DMA benchmark (Id 8) for 1 to 16 tasklets,
+# as well as the overhead of calling a sorting function.
+# For each configuration, the latency of a single DMA and the throughput of all tasklets are stored.
+# Afterwards, the latency of a lone tasklet is fitted to `dma_setup` + `dma_per_byte` × size,
+# which are stored as calibration file of the cost model (see `-k` of the host).
+#
+# Usage: scripts/dma.sh [folder]
+
+CACHE_SIZE=1024
+SEQREAD_CACHE_SIZE=512
+
+b=8
+r=10
+n=0x100000
+
+main_folder=${1:-scripts/dma}
+mkdir -p ${main_folder}
+latencies=${main_folder}/latencies.txt
+calibration=${main_folder}/calibration.txt
+echo "# tasklets test size shift cycles_per_dma bytes_per_cycle" > ${latencies}
+
+# Turns the table printed by the host into lines of the form
+# `<tasklets> <test> <size> <shift> <cycles per DMA> <bytes per cycle>`.
+# The call overhead is stored with a size of 0.
+extract() {
+    awk -v tasklets="${1}" -v size_of_t="${2}" '
+        /^#/ { next }
+        /^n\t/ {
+            num_of_algos = 0
+            for (i = 2; i <= NF; i++)
+                if (substr($i, 1, 4) == "med_")
+                    names[num_of_algos++] = substr($i, 5)
+            next
+        }
+        NF > 1 {
+            part = int($1 * size_of_t / tasklets)
+            for (a = 0; a < num_of_algos; a++) {
+                median = $(4 + 7 * a)
+                if (names[a] == "Call") {
+                    print tasklets, "Call", 0, 0, median, 0
+                    continue
+                }
+                match(names[a], /[0-9]+/)
+                test = substr(names[a], 1, RSTART - 1)
+                size = substr(names[a], RSTART, RLENGTH)
+                shift = (names[a] ~ /Shift$/) ? 8 : 0
+                dmas = int((part - shift) / size)
+                if (dmas > 0 && median > 0)
+                    print tasklets, test, size, shift, median / dmas, tasklets * dmas * size / median
+            }
+        }
+    '
+}
+
+for type in 32 64
+do
+    for nr_tasklets in $(seq 1 16)
+    do
+        make clean
+        NR_TASKLETS=${nr_tasklets} CACHE_SIZE=${CACHE_SIZE} SEQREAD_CACHE_SIZE=${SEQREAD_CACHE_SIZE} TYPE=UINT${type} CHECK_SANITY=false CALL_OVERHEAD=0 make all
+
+        bin/host -b ${b} -r ${r} -c 0 -n $((n / type * 32)) | extract ${nr_tasklets} $((type / 8)) | tee -a ${latencies}
+    done
+done
+
+# Least-squares fit of the latency of aligned reads by a single tasklet.
+awk '
+    $1 == 1 && $2 == "Read" && $4 == 0 {
+        count++; sx += $3; sy += $5; sxx += $3 * $3; sxy += $3 * $5
+    }
+    $1 == 1 && $2 == "Call" { overhead += $5; calls++ }
+    END {
+        per_byte = (count * sxy - sx * sy) / (count * sxx - sx * sx)
+        printf "# Fitted from aligned reads by a single tasklet.\n"
+        printf "dma_setup %.2f\ndma_per_byte %.4f\n", (sy - per_byte * sx) / count, per_byte
+        printf "# Pass to make as CALL_OVERHEAD=%.0f\n", overhead / calls
+    }
+' ${latencies} | tee ${calibration}
@@ -0,0 +1,167 @@
+#!/bin/bash
+
+# Runs every benchmark binary on the functional simulator and lets the host verify the output.
+# Sweeps both types, both settings of STABLE, all distributions, and randomised lengths,
+# including 1, odd lengths, lengths not aligned for DMAs, and powers of the starting run length.
+#
+# Usage: scripts/fuzz.sh [seed]
+#
+# The seed makes the drawn lengths reproducible. The variable ROUNDS sets how many random lengths
+# are drawn per configuration. Each run is killed after TIMEOUT seconds, which counts as a failure.
+# With NATIVE=1, the native builds of the benchmarks are run instead of the simulator,
+# one length at a time. The script exits with status 1 if any run fails.
+
+SEED=${1:-${RANDOM}}
+ROUNDS=${ROUNDS:-4}
+TIMEOUT=${TIMEOUT:-900}
+NATIVE=${NATIVE:-0}
+RANDOM=${SEED}
+echo "# seed: ${SEED}"
+
+r=2
+
+# Configurations of the WRAM benchmarks (Ids 0 to 3) and the MRAM benchmarks (Ids 4 to 7).
+wram_ids="0 1 2 3"
+wram_cache_size=16512
+wram_seqread_cache_size=1024
+mram_ids="4 5 6 7"
+mram_cache_size=1024
+mram_seqread_cache_size=512
+
+# Mirrors `BENCHMARKS` of the makefile, indexed by the Ids of the host.
+benchmarks=(small_wram quick_wram merge_wram heap_wram merge_mram_hs merge_mram_hs_custom \
+        merge_mram_fs merge_par)
+
+log=$(mktemp)
+trap 'rm -f ${log}' EXIT
+failures=0
+
+# Prints the length of the starting runs which an MRAM benchmark reports.
+# It depends on how much WRAM the binary leaves to the tasklets, so it is asked for each one.
+#
+# Usage: starting_run_length <Id>
+starting_run_length() {
+    local b=${1}
+    if [ "${NATIVE}" = "1" ]; then
+        bin/${benchmarks[${b}]}_native -n 1 -r 1
+    else
+        bin/host -s -c 0 -w 0 -r 1 -b ${b} -n 1
+    fi 2>&1 | sed -n 's/^# starting run length=\([0-9]*\)$/\1/p'
+}
+
+# Prints a comma-separated list of fixed edge cases and random lengths below the given maximum.
+draw_lengths() {
+    local max=${1} fixed=${2}
+    local lengths="1,2,3,7,15,17,${fixed}"
+    for ((i = 0; i < ROUNDS; i++)); do
+        local n=$((((RANDOM << 15) | RANDOM) % max + 1))
+        lengths="${lengths},${n},$((n | 1))"
+    done
+    echo "${lengths}"
+}
+
+# Runs a benchmark on the given lengths and distribution and lets its output be verified.
+# Natively, every length is run on its own. Any non-zero exit status, including a timeout,
+# counts as a failure.
+#
+# Usage: run_benchmark <Id> <distribution> <active tasklets or 0 for all> <lengths>
+run_benchmark() {
+    local b=${1} dist=${2} active=${3} lengths=${4}
+    if [ "${NATIVE}" = "1" ]; then
+        local u=() n
+        [ "${active}" != "0" ] && u=(-u ${active})
+        for n in ${lengths//,/ }; do
+            timeout ${TIMEOUT} bin/${benchmarks[${b}]}_native -r ${r} -t ${dist} "${u[@]}" -n ${n} \
+                    || return
+        done
+    else
+        local a=()
+        [ "${active}" != "0" ] && a=(-a ${active})
+        timeout ${TIMEOUT} bin/host -s -v -c 0 -w 0 -r ${r} -b ${b} -t ${dist} "${a[@]}" \
+                -n ${lengths}
+    fi
+}
+
+# Runs a benchmark like `run_benchmark` and reports whether it succeeded.
+# The first argument describes the build configuration.
+run() {
+    local build=${1}
+    shift
+    local config="-b ${1} -t ${2} -a ${3} -n ${4} (${build})"
+    run_benchmark "${@}" > ${log} 2>&1
+    local status=${?}
+    if [ "${status}" = "0" ]; then
+        echo "[OK] ${config}"
+        return
+    elif [ "${status}" = "124" ]; then
+        echo "[TIMEOUT] ${config}"
+    else
+        echo "[FAILED] ${config}"
+    fi
+    grep -v '^#' ${log} | grep -vE '^(n|[0-9]+)\s' | grep -vE '\sok$' | head -n 20
+    failures=$((failures + 1))
+}
+
+# Prints the number of input distributions which the benchmarks know.
+count_distributions() {
+    if [ "${NATIVE}" = "1" ]; then
+        local dist=0
+        while ! bin/small_wram_native -n 1 -t ${dist} 2>&1 | grep -q '^Invalid'; do
+            dist=$((dist + 1))
+        done
+        echo ${dist}
+    else
+        bin/host -t -1 2>&1 | grep -cE '^ +[0-9]+ '
+    fi
+}
+
+run_config() {
+    local ids=${1} cache_size=${2} seqread_cache_size=${3} nr_tasklets=${4} type=${5} stable=${6}
+    local target=$([ "${NATIVE}" = "1" ] && echo native || echo all)
+    make clean > /dev/null
+    if ! NR_TASKLETS=${nr_tasklets} CACHE_SIZE=${cache_size} SEQREAD_CACHE_SIZE=${seqread_cache_size} \
+            TYPE=UINT${type} CHECK_SANITY=true STABLE=${stable} make ${target} > /dev/null; then
+        echo "Building failed: TYPE=UINT${type} STABLE=${stable} NR_TASKLETS=${nr_tasklets}"
+        exit 2
+    fi
+    local nr_of_dists=$(count_distributions)
+    local lengths
+    if [ "${nr_tasklets}" = "1" ]; then  # The WRAM sorts need space for twice the input.
+        local max=$(((cache_size >> (type == 32 ? 2 : 3)) / 2 - 8))
+        lengths=$(draw_lengths ${max} "$((max - 1)),${max}")
+    fi
+    local build="TYPE=UINT${type} STABLE=${stable}"
+    for b in ${ids}; do
+        if [ "${nr_tasklets}" != "1" ]; then
+            local s=$(starting_run_length ${b})
+            if [ -z "${s}" ]; then
+                echo "No starting run length reported: -b ${b} (${build})"
+                exit 2
+            fi
+            lengths=$(draw_lengths $((s * 64)) "$((s - 1)),${s},$((s + 1)),$((s * 2 + 1)),$((s * s))")
+        fi
+        for ((dist = 0; dist < nr_of_dists; dist++)); do
+            run "${build}" ${b} ${dist} 0 ${lengths}
+        done
+        # Tasklet counts which are no power of two give uneven merge trees and splits in MergePar,
+        # where runs of a single item and odd borders are common with almost sorted inputs.
+        if [ "${nr_tasklets}" != "1" ]; then
+            for active in 11 13; do
+                run "${build}" ${b} 2 ${active} 1025,5000
+            done
+            # An odd number of active tasklets leaves parked tasklets with empty parts,
+            # which MergeFSPipe pairs with tasklets which sort.
+            run "${build}" ${b} 4 3 1,2,3,7,15,17
+        fi
+    done
+}
+
+for type in 32 64; do
+    for stable in false true; do
+        run_config "${wram_ids}" ${wram_cache_size} ${wram_seqread_cache_size} 1 ${type} ${stable}
+        run_config "${mram_ids}" ${mram_cache_size} ${mram_seqread_cache_size} 16 ${type} ${stable}
+    done
+done
+
+echo "# ${failures} failed run(s), seed: ${SEED}"
+[ "${failures}" = "0" ]
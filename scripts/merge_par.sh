@@ -1,8 +1,5 @@
 #!/bin/bash
 
-CACHE_SIZE=1024
-SEQREAD_CACHE_SIZE=512
-
 b=7
 r=10
 n=0x800000
@@ -10,8 +7,17 @@ n=0x800000
 main_folder=scripts/merge_par
 mkdir -p ${main_folder}
 
-for nr_tasklets in 1 2 4 8 16
+for nr_tasklets in 1 2 4 8 11 12 16 20 24
 do
+    # Beyond 16 tasklets, the default buffers no longer fit into the WRAM.
+    if [ ${nr_tasklets} -gt 16 ]
+    then
+        CACHE_SIZE=512
+        SEQREAD_CACHE_SIZE=256
+    else
+        CACHE_SIZE=1024
+        SEQREAD_CACHE_SIZE=512
+    fi
     tasklets_folder=${main_folder}/NR_TASKLETS=${nr_tasklets}
     for stable in false
     do
@@ -0,0 +1,134 @@
+#!/bin/bash
+
+# Runs a fixed matrix of benchmarks and either stores the medians as baseline
+# or compares them against a stored baseline.
+#
+# Usage: scripts/regression.sh record|check [baseline file]
+#
+# A measurement counts as a regression if its median is more than TOLERANCE percent slower
+# than the baseline median and if the bootstrap confidence intervals of both medians do not overlap.
+# In check mode, the script exits with status 1 if any regression is found
+# or if a measurement of the baseline is missing.
+# If a build or a benchmark run fails, it exits with status 2 and records or checks nothing.
+
+set -o pipefail
+
+mode=${1}
+baseline=${2:-scripts/regression/baseline.txt}
+TOLERANCE=${TOLERANCE:-2}
+
+if [ "${mode}" != "record" ] && [ "${mode}" != "check" ];
+then
+    echo "Usage: ${0} record|check [baseline file]"
+    exit 2
+fi
+if [ "${mode}" = "check" ] && [ ! -f "${baseline}" ];
+then
+    echo "The baseline ‘${baseline}’ does not exist! Run ‘${0} record’ first."
+    exit 2
+fi
+
+r=20
+dists=("sorted" "reverse" "almost" "zeroone" "uniform" "zipf")
+
+# Configurations of the WRAM benchmarks (Ids 0 to 3) and the MRAM benchmarks (Ids 4 to 7).
+wram_ids="0 1 2 3"
+wram_cmd="NR_TASKLETS=1 CACHE_SIZE=16512 SEQREAD_CACHE_SIZE=1024 CHECK_SANITY=false"
+wram_n="16,64,256,1024"
+mram_ids="4 5 6 7"
+mram_cmd="NR_TASKLETS=16 CACHE_SIZE=1024 SEQREAD_CACHE_SIZE=512 CHECK_SANITY=false"
+mram_n="0x10000,0x100000"
+
+current=$(mktemp)
+trap 'rm -f ${current}' EXIT
+failures=0
+
+# Turns the table printed by the host into lines of the form
+# `<key> <algorithm> <n> <median> <lower CI bound> <upper CI bound>`.
+extract() {
+    awk -v key="${1}" '
+        /^#/ { next }
+        /^n\t/ {
+            num_of_algos = 0
+            for (i = 2; i <= NF; i++)
+                if (substr($i, 1, 4) == "med_")
+                    names[num_of_algos++] = substr($i, 5)
+            next
+        }
+        NF > 1 {
+            for (a = 0; a < num_of_algos; a++)
+                print key, names[a], $1, $(4 + 7 * a), $(7 + 7 * a), $(8 + 7 * a)
+        }
+    '
+}
+
+run_matrix() {
+    local cmd=${1} ids=${2} n=${3}
+    for type in 32 64
+    do
+        make clean > /dev/null
+        eval "TYPE=UINT${type} ${cmd} make all" > /dev/null || exit 2
+        for b in ${ids}
+        do
+            for dist in "${!dists[@]}";
+            do
+                local key="b=${b},type=uint${type},dist=${dists[${dist}]}"
+                if ! bin/host -b ${b} -r ${r} -c 0 -t ${dist} -n ${n} | extract "${key}" >> ${current};
+                then
+                    echo "[FAILED] ${key}, n=${n}"
+                    failures=$((failures + 1))
+                fi
+            done
+        done
+    done
+}
+
+run_matrix "${wram_cmd}" "${wram_ids}" "${wram_n}"
+run_matrix "${mram_cmd}" "${mram_ids}" "${mram_n}"
+
+if [ "${failures}" != "0" ];
+then
+    echo "${failures} benchmark run(s) failed, so the measurements are incomplete."
+    exit 2
+fi
+
+if [ "${mode}" = "record" ];
+then
+    mkdir -p $(dirname ${baseline})
+    cp ${current} ${baseline}
+    echo "Recorded $(wc -l < ${baseline}) measurements in ‘${baseline}’."
+    exit 0
+fi
+
+awk -v tolerance="${TOLERANCE}" '
+    NR == FNR {
+        id = $1 " " $2 " " $3
+        base_median[id] = $4
+        base_high[id] = $6
+        next
+    }
+    {
+        id = $1 " " $2 " " $3
+        if (!(id in base_median)) {
+            printf "new:        %s (median %.1f)\n", id, $4
+            next
+        }
+        seen[id] = 1
+        change = ($4 - base_median[id]) / ((base_median[id] > 0) ? base_median[id] : 1) * 100
+        if (change > tolerance && $5 > base_high[id]) {
+            printf "REGRESSION: %s: %.1f -> %.1f cycles (%+.1f %%)\n", id, base_median[id], $4, change
+            regressions++
+        } else if (change < -tolerance) {
+            printf "improved:   %s: %.1f -> %.1f cycles (%+.1f %%)\n", id, base_median[id], $4, change
+        }
+    }
+    END {
+        for (id in base_median)
+            if (!(id in seen)) {
+                printf "missing:    %s\n", id
+                missing++
+            }
+        printf "%d regression(s) and %d missing measurement(s) found.\n", regressions, missing
+        exit (regressions > 0 || missing > 0)
+    }
+' ${baseline} ${current}
@@ -0,0 +1,77 @@
+/**
+ * @file
+ * @brief The sizes of the WRAM buffers and of the starting runs, shared by the DPU and the host.
+ *
+ * The arenas of the tasklets are sized at runtime and may be larger than a triple buffer,
+ * so everything derived from `TRIPLE_BUFFER_SIZE` is a lower bound.
+ * The DPU reports the actual length of its starting runs in `dpu_results`.
+**/
+
+#ifndef _BUFFER_SIZES_H_
+#define _BUFFER_SIZES_H_
+
+#include "common.h"
+#include "communication.h"
+
+/// @brief The minimum size of a general-purpose buffer & two sequential-reader buffers.
+#define TRIPLE_BUFFER_SIZE ((CACHE_SIZE + 4 * SEQREAD_CACHE_SIZE) & ~(DMA_ALIGNMENT - 1))
+/// @brief The min. number of elements in a general-purpose buffer & two sequential-reader buffers.
+#define TRIPLE_BUFFER_LENGTH (TRIPLE_BUFFER_SIZE >> DIV)
+/// @brief The maximum number of bytes transferable at once between MRAM and a triple buffer.
+#define MAX_TRANSFER_SIZE_TRIPLE (((TRIPLE_BUFFER_SIZE > 2048) ? 2048 : TRIPLE_BUFFER_SIZE) \
+        & ~(DMA_ALIGNMENT - 1))
+/// @brief The maximum number of elements transferable at once between MRAM and a triple buffer.
+#define MAX_TRANSFER_LENGTH_TRIPLE (MAX_TRANSFER_SIZE_TRIPLE >> DIV)
+/// @brief The maximum number of bytes transferable at once between MRAM and the cache.
+#define MAX_TRANSFER_SIZE_CACHE (((CACHE_SIZE > 2048) ? 2048 : CACHE_SIZE) & ~(DMA_ALIGNMENT - 1))
+/// @brief The maximum number of elements transferable at once between MRAM and the cache.
+#define MAX_TRANSFER_LENGTH_CACHE (MAX_TRANSFER_SIZE_CACHE >> DIV)
+/// @brief How much space is needed by sentinels.
+#define SENTINELS_SIZE (DMA_ALIGNED(1 << DIV))
+/// @brief How many sentinels there are (e.g. 2 for 32-bit integers, 1 for 64-bit integers).
+#define SENTINELS_NUMS (SENTINELS_SIZE >> DIV)
+
+/// @brief The number of pointers in the call stack of the iterative QuickSort.
+#define CALL_STACK_LENGTH (40)
+
+#ifndef WRAM_POINTER_SIZE
+/// @brief The size of a pointer into the WRAM, which the host cannot take from `sizeof`.
+#define WRAM_POINTER_SIZE (4)
+#endif
+
+#if (STABLE) || defined(UINT64)
+
+/// @brief The space at the end of an arena which must stay free while forming starting runs.
+#define STARTING_RUN_RESERVE (0)
+
+#else
+
+/// @brief The space at the end of an arena which must stay free while forming starting runs,
+/// namely the call stack of the iterative QuickSort.
+#define STARTING_RUN_RESERVE (DMA_ALIGNED(CALL_STACK_LENGTH * WRAM_POINTER_SIZE))
+
+#endif  // STABLE || UINT64
+
+#if (STABLE)
+
+/// @brief The number of items in a starting run which is sorted within `size` bytes of WRAM.
+#define RUN_LENGTH_IN(size) (((((size) >> DIV) - SENTINELS_NUMS) / 2 >> DIV) << DIV)
+
+#else
+
+/// @brief The number of items in a starting run which is sorted within `size` bytes of WRAM.
+#define RUN_LENGTH_IN(size) (((size) >> DIV) - SENTINELS_NUMS)
+
+#endif  // STABLE
+
+#ifndef STARTING_RUN_POOL
+/// @brief How many neighbouring tasklets pool their WRAM to form longer starting runs.
+#define STARTING_RUN_POOL (1)
+#endif
+
+/// @brief The size of the output cache of a tasklet while merging its pooled slice.
+#define POOL_OUT_SIZE (256)
+/// @brief The number of items in the output cache of a tasklet while merging its pooled slice.
+#define POOL_OUT_LENGTH (POOL_OUT_SIZE >> DIV)
+
+#endif  // _BUFFER_SIZES_H_
@@ -1,6 +1,6 @@
 /**
  * @file
- * @brief Shared data type for sorting, swap function, CLI font colour, and the sequential reader.
+ * @brief Shared data type, swap and hash functions, CLI font colour, and the sequential reader.
 **/
 
 #ifndef _COMMON_H_
@@ -53,4 +53,57 @@ static __attribute__((__always_inline__)) inline void swap(T * const a, T * cons
     *b = temp;
 }
 
+#if defined(UINT32)
+
+/// @brief Two neighbouring items, accessed through a single 64-bit load or store.
+/// The first item is the lower half since the DPU is little-endian.
+typedef uint64_t __attribute__((__may_alias__)) T_pair;
+
+/**
+ * @brief Reads two neighbouring items with a single 64-bit load.
+ *
+ * @param from The address of the first item. Must be aligned to `sizeof(T_pair)`.
+ * @param first Whither to store the first item.
+ * @param second Whither to store the second item.
+**/
+static __attribute__((__always_inline__)) inline void load_pair(T const * const from,
+        T * const first, T * const second) {
+    T_pair const pair = *(T_pair const *)from;
+    *first = (T)pair;
+    *second = (T)(pair >> 32);
+}
+
+/**
+ * @brief Writes two neighbouring items with a single 64-bit store.
+ *
+ * @param to Whither to write the first item. Must be aligned to `sizeof(T_pair)`.
+ * @param first The first item.
+ * @param second The second item.
+**/
+static __attribute__((__always_inline__)) inline void store_pair(T * const to, T const first,
+        T const second) {
+    *(T_pair *)to = ((T_pair)second << 32) | first;
+}
+
+#endif  // UINT32
+
+/**
+ * @brief Mixes the bits of a key through Thomas Wang’s 64-bit hash, which needs no multiplications.
+ * The sum of the hashes of some keys is a fingerprint of their multiset, independent of their order.
+ * 
+ * @param key The key to hash.
+ * 
+ * @return The hash of the key.
+**/
+static __attribute__((__always_inline__)) inline uint64_t hash_key(uint64_t key) {
+    key = ~key + (key << 21);
+    key ^= key >> 24;
+    key += (key << 3) + (key << 8);
+    key ^= key >> 14;
+    key += (key << 2) + (key << 4);
+    key ^= key >> 28;
+    key += key << 31;
+    return key;
+}
+
 #endif  // _COMMON_H_
@@ -6,6 +6,7 @@
 #ifndef _COMMUNICATION_H_
 #define _COMMUNICATION_H_
 
+#include <assert.h>
 #include <stdint.h>
 
 #include "common.h"
@@ -53,6 +54,25 @@
 #error The size of elements to load into MRAM must be divisible by `DMA_ALIGNMENT`.
 #endif
 
+/// @brief The distributions from which the input can be drawn, both by the host and by a DPU.
+enum dist {
+    sorted,
+    reverse,
+    almost,
+    zeroone,
+    uniform,
+    zipf,
+    normal,
+    sawtooth,
+    organpipe,
+    sortedruns,
+    fewunique,
+    shuffledblocks,
+    medkiller,
+    mergekiller,
+    nr_of_dists,
+};
+
 /// @brief Every WRAM sorting function must adher to this pattern.
 typedef void sort_algo_wram(T *, T *);
 
@@ -80,18 +100,43 @@ struct dpu_arguments {
     uint32_t basic_seed;
     /// @brief The index of the sorting algorithm to run.
     uint32_t algo_index;
+    /// @brief Whether the sorted data are to be written back to their original place in `input`
+    /// so that the host can verify them.
+    /// MRAM sorts leave their data where `dpu_results.parts_in_output` tells instead.
+    uint32_t write_back;
+    /// @brief How many tasklets sort, from 1 to `NR_TASKLETS`. Only MRAM sorts heed it.
+    /// The others are parked with an empty part but may still help to form starting runs.
+    uint32_t active_tasklets;
 };
+static_assert(
+    sizeof(struct dpu_arguments) % DMA_ALIGNMENT == 0,
+    "The arguments are sent to the DPU via a DMA and so their size must be properly aligned!"
+);
 
 /// @brief The data type holding the performance counter count.
 /// This is needed since `perfcounter_t` is only available on a DPU.
 typedef uint64_t dpu_time;
 
+/// @brief The maximum number of repetitions performed during a single launch.
+/// Each repetition yields one measured time which is sent back individually.
+#define MAX_REPS_PER_LAUNCH (64)
+
 /// @brief Information sent from the DPU to the host.
 struct dpu_results {
-    /// @brief The sum of the measured times.
-    dpu_time firsts;
-    /// @brief The sum of the squares of the measured times.
-    dpu_time seconds;
+    /// @brief Into how many independently sorted parts the data of each repetition are split.
+    /// All parts but the last one have a length of `part_length`.
+    uint32_t sorted_parts;
+    /// @brief How many elements of each repetition are sorted, possibly including the padding.
+    uint32_t sorted_length;
+    /// @brief Which parts lie in `output` rather than in `input` once sorted, one bit per part.
+    /// The same parts are affected in every repetition.
+    uint32_t parts_in_output;
+    /// @brief How many items the starting runs of an MRAM MergeSort have,
+    /// which depends on how much WRAM is left for each tasklet. Zero for WRAM sorts.
+    uint32_t starting_run_length;
+    /// @brief The measured time of each repetition.
+    /// Only the first `reps` entries are valid.
+    dpu_time times[MAX_REPS_PER_LAUNCH];
 };
 
 /// @brief A sorting algorithm and its name.
@@ -111,7 +156,10 @@ union algo_to_test {
     char padding[24];
 };
 
+#ifndef CALL_OVERHEAD
 /// @brief The experimentally determined overhead of calling a sorting function in cycles.
+/// Can be measured anew with the test `Call` of the DMA benchmark.
 #define CALL_OVERHEAD (144)
+#endif
 
 #endif  // _COMMUNICATION_H_